@@ -0,0 +1,40 @@
+#include <benchmarks/benchmark.h>
+
+#include <raytracer/scalar.h>
+#include <raytracer/simd.h>
+
+
+namespace
+{
+volatile double sink = 0.0; ///< Destination of kept values.
+} // namespace
+
+//------------------------------------------------------------------------------
+void BenchmarkRunner::write_json(std::ostream& a_output) const
+{
+  const char* precision = sizeof(Scalar) == sizeof(float) ? "float" : "double";
+  a_output << "{\n  \"simd\": \"" << simd::backend_name() << "\",";
+  a_output << "\n  \"precision\": \"" << precision << "\",";
+  a_output << "\n  \"benchmarks\": [";
+  for (size_t i = 0; i < results_.size(); ++i)
+  {
+    const BenchmarkResult& result = results_[i];
+    a_output << (i == 0 ? "\n" : ",\n");
+    a_output << "    {\"name\": \"" << result.name << "\""
+             << ", \"iterations\": " << result.iterations
+             << ", \"ns_per_op\": " << result.ns_per_op;
+    if (result.rays_per_op > 0)
+    {
+      double rays_per_second = result.rays_per_op * 1.0e9 / result.ns_per_op;
+      a_output << ", \"rays_per_second\": " << rays_per_second;
+    }
+    a_output << "}";
+  }
+  a_output << "\n  ]\n}\n";
+}
+
+//------------------------------------------------------------------------------
+void keep(double a_value)
+{
+  sink = sink + a_value;
+}
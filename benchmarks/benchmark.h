@@ -0,0 +1,92 @@
+#pragma once
+
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+/// Timing of a single benchmark.
+struct BenchmarkResult
+{
+  std::string name;          ///< Name of the benchmark.
+  long long iterations = 0;  ///< Number of times the operation was run.
+  double ns_per_op = 0.0;    ///< Average wall time of one operation.
+  double rays_per_op = 0.0;  ///< Rays cast by one operation (0 if none).
+};
+
+/// Runs benchmarks and reports their timings as JSON.
+class BenchmarkRunner
+{
+public:
+  /// Construct a runner.
+  /// \param a_filter Only benchmarks whose name contains this are run.
+  /// \param a_min_seconds The least time to spend running each benchmark.
+  explicit BenchmarkRunner(const std::string& a_filter = "",
+      double a_min_seconds = 0.25)
+      : filter_(a_filter)
+        , min_seconds_(a_min_seconds)
+  {
+  }
+
+  /// Time an operation, running it until the minimum time has passed.
+  /// \param a_name The name of the benchmark.
+  /// \param a_operation The operation to time.
+  /// \param a_rays_per_op The number of rays cast by one operation.
+  template <typename Operation>
+  void run(const std::string& a_name, Operation a_operation,
+      double a_rays_per_op = 0.0);
+
+  /// Get the results of the benchmarks run so far.
+  /// \return The results in the order run.
+  const std::vector<BenchmarkResult>& results() const
+  {
+    return results_;
+  }
+
+  /// Write the results as a JSON document.
+  /// \param a_output The stream to write to.
+  void write_json(std::ostream& a_output) const;
+
+private:
+  std::string filter_;                   ///< Substring of names to run.
+  double min_seconds_;                   ///< Least time to run each benchmark.
+  std::vector<BenchmarkResult> results_; ///< Results in the order run.
+};
+
+/// Keep a value alive so the computation producing it is not optimized away.
+/// \param a_value The value to keep.
+void keep(double a_value);
+
+//------------------------------------------------------------------------------
+template <typename Operation>
+void BenchmarkRunner::run(const std::string& a_name, Operation a_operation,
+    double a_rays_per_op)
+{
+  if (a_name.find(filter_) == std::string::npos)
+    return;
+
+  // double the batch size until a batch takes long enough to time reliably
+  long long iterations = 1;
+  double seconds = 0.0;
+  while (true)
+  {
+    auto start = std::chrono::steady_clock::now();
+    for (long long i = 0; i < iterations; ++i)
+    {
+      a_operation();
+    }
+    auto end = std::chrono::steady_clock::now();
+    seconds = std::chrono::duration<double>(end - start).count();
+    if (seconds >= min_seconds_)
+      break;
+    iterations *= 2;
+  }
+
+  BenchmarkResult result;
+  result.name = a_name;
+  result.iterations = iterations;
+  result.ns_per_op = seconds * 1.0e9 / iterations;
+  result.rays_per_op = a_rays_per_op;
+  results_.push_back(result);
+}
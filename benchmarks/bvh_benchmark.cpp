@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <raytracer/sphere.h>
+#include <raytracer/transform.h>
+#include <raytracer/world.h>
+
+
+namespace
+{
+
+//------------------------------------------------------------------------------
+World random_world(int a_count)
+{
+  // keep the density of spheres the same as the count grows
+  double extent = 5 * std::cbrt(static_cast<double>(a_count));
+  std::mt19937 generator(1);
+  std::uniform_real_distribution<double> position(-extent, extent);
+  std::uniform_real_distribution<double> size(0.2, 1.0);
+  World world;
+  world.set_light(Light::new_ptr(point(-10, 10, -10), Color(1, 1, 1)));
+  for (int i = 0; i < a_count; ++i)
+  {
+    auto sphere = Sphere::new_ptr();
+    sphere->set_transform(translation(position(generator), position(generator),
+                                      position(generator)) *
+                          scaling(size(generator), size(generator),
+                                  size(generator)));
+    world.add_object(std::move(sphere));
+  }
+  return world;
+}
+
+//------------------------------------------------------------------------------
+std::vector<Ray> random_rays(int a_count, int a_object_count)
+{
+  double extent = 5 * std::cbrt(static_cast<double>(a_object_count));
+  std::mt19937 generator(2);
+  std::uniform_real_distribution<double> coordinate(-1, 1);
+  std::vector<Ray> rays;
+  for (int i = 0; i < a_count; ++i)
+  {
+    Tuple direction = vector(coordinate(generator), coordinate(generator),
+                             coordinate(generator)).normalize();
+    rays.emplace_back(point(0, 0, 0) - direction * (2 * extent), direction);
+  }
+  return rays;
+}
+
+//------------------------------------------------------------------------------
+double nanoseconds_per_ray(const World& a_world, const std::vector<Ray>& a_rays)
+{
+  auto start = std::chrono::steady_clock::now();
+  size_t hits = 0;
+  for (auto& ray : a_rays)
+  {
+    hits += a_world.intersect(ray).size();
+  }
+  auto end = std::chrono::steady_clock::now();
+  // use the result so the work is not optimized away
+  if (hits == static_cast<size_t>(-1))
+    std::cerr << hits;
+  std::chrono::duration<double, std::nano> elapsed = end - start;
+  return elapsed.count() / a_rays.size();
+}
+
+} // namespace
+
+/// Compare World::intersect with and without a bounding volume hierarchy as
+/// the number of objects grows.
+/// Usage: bvh_bench [max_object_count]
+int main(int argc, char* argv[])
+{
+  int max_count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+  std::cout << "objects,build_ms,brute_ns_per_ray,bvh_ns_per_ray,speedup\n";
+  for (int count = 10; count <= max_count; count *= 10)
+  {
+    World world = random_world(count);
+
+    // testing every object is linear, so use fewer rays as the count grows
+    int brute_ray_count = std::max(10, 10000000 / count);
+    if (brute_ray_count > 10000)
+      brute_ray_count = 10000;
+    double brute = nanoseconds_per_ray(world,
+                                       random_rays(brute_ray_count, count));
+
+    auto start = std::chrono::steady_clock::now();
+    world.build_bvh();
+    auto end = std::chrono::steady_clock::now();
+    std::chrono::duration<double, std::milli> build = end - start;
+
+    double bvh = nanoseconds_per_ray(world, random_rays(10000, count));
+    std::cout << count << "," << build.count() << "," << brute << "," << bvh
+              << "," << brute / bvh << "\n";
+  }
+  return 0;
+}
@@ -0,0 +1,409 @@
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <benchmarks/benchmark.h>
+#include <raytracer/camera.h>
+#include <raytracer/canvas.h>
+#include <raytracer/light.h>
+#include <raytracer/material.h>
+#include <raytracer/matrix.h>
+#include <raytracer/plane.h>
+#include <raytracer/scene_cache.h>
+#include <raytracer/scene_file.h>
+#include <raytracer/scenes.h>
+#include <raytracer/scheduler.h>
+#include <raytracer/sphere.h>
+#include <raytracer/trace.h>
+#include <raytracer/transform.h>
+#include <raytracer/world.h>
+
+
+namespace
+{
+
+//------------------------------------------------------------------------------
+void math_benchmarks(BenchmarkRunner& a_runner)
+{
+  Matrix m = translation(1, 2, 3) * rotation_y(0.5) * scaling(2, 3, 4);
+  a_runner.run("matrix_inverse", [&]()
+  {
+    keep(m.inverse()[0][0]);
+  });
+
+  Tuple p = point(1, 2, 3);
+  a_runner.run("matrix_times_tuple", [&]()
+  {
+    p = m * p;
+    keep(p.x());
+  });
+}
+
+/// Number of values each kernel benchmark works through per iteration.
+const int KERNEL_BATCH = 256;
+
+/// Scalar tuple addition as written before the simd kernels.
+Tuple reference_add(const Tuple& a_lhs, const Tuple& a_rhs)
+{
+  return {a_lhs.x() + a_rhs.x(), a_lhs.y() + a_rhs.y(), a_lhs.z() + a_rhs.z(),
+          a_lhs.w() + a_rhs.w()};
+}
+
+/// Scalar dot product as written before the simd kernels.
+double reference_dot(const Tuple& a_lhs, const Tuple& a_rhs)
+{
+  return a_lhs.x() * a_rhs.x() + a_lhs.y() * a_rhs.y() + a_lhs.z() * a_rhs.z() +
+         a_lhs.w() * a_rhs.w();
+}
+
+/// Scalar cross product as written before the simd kernels.
+Tuple reference_cross(const Tuple& a_lhs, const Tuple& a_rhs)
+{
+  return vector(a_lhs.y() * a_rhs.z() - a_lhs.z() * a_rhs.y(),
+                a_lhs.z() * a_rhs.x() - a_lhs.x() * a_rhs.z(),
+                a_lhs.x() * a_rhs.y() - a_lhs.y() * a_rhs.x());
+}
+
+/// Scalar color product as written before the simd kernels.
+Color reference_multiply(const Color& a_lhs, const Color& a_rhs)
+{
+  return {a_lhs.red() * a_rhs.red(), a_lhs.green() * a_rhs.green(),
+          a_lhs.blue() * a_rhs.blue()};
+}
+
+/// Scalar matrix and tuple product as written before the simd kernels.
+Tuple reference_transform(const Matrix4& a_lhs, const Tuple& a_rhs)
+{
+  return {a_lhs(0, 0) * a_rhs.x() + a_lhs(0, 1) * a_rhs.y() +
+          a_lhs(0, 2) * a_rhs.z() + a_lhs(0, 3) * a_rhs.w(),
+          a_lhs(1, 0) * a_rhs.x() + a_lhs(1, 1) * a_rhs.y() +
+          a_lhs(1, 2) * a_rhs.z() + a_lhs(1, 3) * a_rhs.w(),
+          a_lhs(2, 0) * a_rhs.x() + a_lhs(2, 1) * a_rhs.y() +
+          a_lhs(2, 2) * a_rhs.z() + a_lhs(2, 3) * a_rhs.w(),
+          a_lhs(3, 0) * a_rhs.x() + a_lhs(3, 1) * a_rhs.y() +
+          a_lhs(3, 2) * a_rhs.z() + a_lhs(3, 3) * a_rhs.w()};
+}
+
+//------------------------------------------------------------------------------
+void kernel_benchmarks(BenchmarkRunner& a_runner)
+{
+  // each benchmark runs over a batch of independent values so it measures
+  // throughput rather than the latency of one dependent chain
+  std::vector<Tuple> lhs, rhs, tuples(KERNEL_BATCH);
+  std::vector<Color> colors_lhs, colors_rhs, colors(KERNEL_BATCH);
+  for (int i = 0; i < KERNEL_BATCH; ++i)
+  {
+    lhs.push_back(vector(i * 0.5, 1.0 - i, 2.0 + i * 0.25));
+    rhs.push_back(vector(3.0 - i * 0.75, i * 0.125, 1.5));
+    colors_lhs.push_back(Color(i / 256.0, 0.5, 1.0 - i / 256.0));
+    colors_rhs.push_back(Color(0.25, i / 512.0, 0.75));
+  }
+  Matrix4 m = (translation(1, 2, 3) * rotation_y(0.5) *
+               scaling(2, 3, 4)).to_matrix4();
+
+  std::string batch = "_x" + std::to_string(KERNEL_BATCH);
+  a_runner.run("tuple_add" + batch, [&]()
+  {
+    for (int i = 0; i < KERNEL_BATCH; ++i)
+      tuples[i] = lhs[i] + rhs[i];
+    keep(tuples[0].x());
+  });
+  a_runner.run("tuple_add_reference" + batch, [&]()
+  {
+    for (int i = 0; i < KERNEL_BATCH; ++i)
+      tuples[i] = reference_add(lhs[i], rhs[i]);
+    keep(tuples[0].x());
+  });
+  a_runner.run("tuple_dot" + batch, [&]()
+  {
+    double sum = 0.0;
+    for (int i = 0; i < KERNEL_BATCH; ++i)
+      sum += dot(lhs[i], rhs[i]);
+    keep(sum);
+  });
+  a_runner.run("tuple_dot_reference" + batch, [&]()
+  {
+    double sum = 0.0;
+    for (int i = 0; i < KERNEL_BATCH; ++i)
+      sum += reference_dot(lhs[i], rhs[i]);
+    keep(sum);
+  });
+  a_runner.run("tuple_cross" + batch, [&]()
+  {
+    for (int i = 0; i < KERNEL_BATCH; ++i)
+      tuples[i] = cross(lhs[i], rhs[i]);
+    keep(tuples[0].x());
+  });
+  a_runner.run("tuple_cross_reference" + batch, [&]()
+  {
+    for (int i = 0; i < KERNEL_BATCH; ++i)
+      tuples[i] = reference_cross(lhs[i], rhs[i]);
+    keep(tuples[0].x());
+  });
+  a_runner.run("color_multiply" + batch, [&]()
+  {
+    for (int i = 0; i < KERNEL_BATCH; ++i)
+      colors[i] = colors_lhs[i] * colors_rhs[i];
+    keep(colors[0].red());
+  });
+  a_runner.run("color_multiply_reference" + batch, [&]()
+  {
+    for (int i = 0; i < KERNEL_BATCH; ++i)
+      colors[i] = reference_multiply(colors_lhs[i], colors_rhs[i]);
+    keep(colors[0].red());
+  });
+  a_runner.run("matrix4_times_tuple" + batch, [&]()
+  {
+    for (int i = 0; i < KERNEL_BATCH; ++i)
+      tuples[i] = m * lhs[i];
+    keep(tuples[0].x());
+  });
+  a_runner.run("matrix4_times_tuple_reference" + batch, [&]()
+  {
+    for (int i = 0; i < KERNEL_BATCH; ++i)
+      tuples[i] = reference_transform(m, lhs[i]);
+    keep(tuples[0].x());
+  });
+}
+
+//------------------------------------------------------------------------------
+void intersect_benchmarks(BenchmarkRunner& a_runner)
+{
+  Sphere sphere;
+  sphere.set_transform(translation(0, 0, 1) * scaling(2, 2, 2));
+  Ray hit_ray(point(0, 0, -5), vector(0, 0, 1));
+  a_runner.run("sphere_intersect", [&]()
+  {
+    keep(sphere.intersect(hit_ray).size());
+  });
+  Plane plane;
+  plane.set_transform(translation(0, 0, 5) * rotation_x(M_PI_2));
+  a_runner.run("plane_intersect", [&]()
+  {
+    keep(plane.intersect(hit_ray).size());
+  });
+  a_runner.run("plane_intersect_distance", [&]()
+  {
+    Scalar t;
+    keep(plane.intersect_distance(hit_ray, t) ? t : 0);
+  });
+
+  World world = chapter_7_world();
+  Ray world_ray = chapter_7_camera(200, 100).ray_for_pixel(100, 50);
+  a_runner.run("world_intersect", [&]()
+  {
+    keep(world.intersect(world_ray).size());
+  }, 1);
+  Intersections intersections;
+  a_runner.run("world_intersect_reused_list", [&]()
+  {
+    world.intersect(world_ray, intersections);
+    keep(intersections.size());
+  }, 1);
+  a_runner.run("world_color_at", [&]()
+  {
+    keep(world.color_at(world_ray).red());
+  }, 1);
+}
+
+//------------------------------------------------------------------------------
+void shading_benchmarks(BenchmarkRunner& a_runner)
+{
+  Material material;
+  Light light(point(0, 10, -10), Color(1, 1, 1));
+  Tuple position = point(0, 0, 0);
+  Tuple to_eye = vector(0, 0.6, -0.8);
+  Tuple normal = vector(0, 0, -1);
+  a_runner.run("lighting", [&]()
+  {
+    keep(lighting(material, light, position, to_eye, normal, false).red());
+  });
+  Material fractional_material;
+  fractional_material.set_shininess(200.5);
+  a_runner.run("lighting_pow_shininess", [&]()
+  {
+    keep(lighting(fractional_material, light, position, to_eye, normal,
+                  false).red());
+  });
+
+  // a floor point lit by 16 lights around the scene, half of them under it
+  World world = chapter_7_world();
+  world.build_bvh();
+  for (int i = 0; i < 16; ++i)
+  {
+    Scalar angle = Scalar(i) * 2 * Scalar(M_PI) / 16;
+    Scalar height = i % 2 == 0 ? 10 : -10;
+    world.add_light(Light(point(10 * std::cos(angle), height,
+                                10 * std::sin(angle)), Color(0.1, 0.1, 0.1)));
+  }
+  Ray ray(point(0, 1.5, -5), vector(0.1, -0.3, 1).normalize());
+  Scalar t;
+  const Shape* object = world.closest_hit(ray, t);
+  Computations computations =
+      Intersection(t, *object).prepare_computations(ray);
+  a_runner.run("shade_hit_17_lights", [&]()
+  {
+    keep(world.shade_hit(computations).red());
+  });
+  a_runner.run("shade_hit_17_lights_reference", [&]()
+  {
+    Color color;
+    for (int i = 0; i < world.light_count(); ++i)
+    {
+      bool shadowed = world.is_shadowed(computations.over_point,
+                                        world.light(i));
+      color = color + lighting(object->material(), world.light(i),
+                               computations.point, computations.to_eye,
+                               computations.normal, shadowed);
+    }
+    keep(color.red());
+  });
+}
+
+//------------------------------------------------------------------------------
+void output_benchmarks(BenchmarkRunner& a_runner)
+{
+  Canvas canvas(640, 360);
+  for (int y = 0; y < canvas.height(); ++y)
+    for (int x = 0; x < canvas.width(); ++x)
+      canvas.write_pixel(x, y, Color(x / 640.0, y / 360.0, 0.5));
+
+  a_runner.run("canvas_to_ppm_p3_640x360", [&]()
+  {
+    std::ostringstream out;
+    canvas.to_ppm_file(out);
+    keep(out.str().size());
+  });
+  a_runner.run("canvas_to_ppm_p6_640x360", [&]()
+  {
+    std::ostringstream out;
+    canvas.to_ppm_file(out, PpmFormat::P6);
+    keep(out.str().size());
+  });
+}
+
+//------------------------------------------------------------------------------
+void scene_benchmarks(BenchmarkRunner& a_runner)
+{
+  // a grid of transformed spheres sharing two materials
+  std::ostringstream text;
+  text << "camera 640 360 1.0472 from 0 1.5 -5 to 0 1 0 up 0 1 0\n"
+       << "light -10 10 -10 1 1 1\n"
+       << "material red color 1 0.2 0.1 diffuse 0.7 specular 0.3\n"
+       << "material blue color 0.1 0.2 1 shininess 50\n";
+  const int count = 100000;
+  for (int i = 0; i < count; ++i)
+  {
+    text << "sphere " << (i % 2 ? "red" : "blue") << " translate "
+         << i % 100 * 1.5 << " " << i / 100 % 100 * 1.5 << " "
+         << i / 10000 * 1.5 << " scale 0.5 0.5 0.5\n";
+  }
+  std::string scene_text = text.str();
+
+  a_runner.run("scene_parse_100k_spheres", [&]()
+  {
+    Scene scene;
+    std::string error;
+    parse_scene(scene_text.data(), scene_text.size(), scene, error);
+    keep(scene.world.object_count());
+  });
+
+  // the same scene loaded from a cache needs no parsing or BVH build
+  Scene scene;
+  std::string error;
+  parse_scene(scene_text.data(), scene_text.size(), scene, error);
+  save_scene_cache("scene_bench.rtscene", scene, error);
+  a_runner.run("scene_cache_load_100k_spheres", [&]()
+  {
+    Scene cached;
+    load_scene_cache("scene_bench.rtscene", cached, error);
+    keep(cached.world.object_count());
+  });
+  std::remove("scene_bench.rtscene");
+}
+
+//------------------------------------------------------------------------------
+void render_benchmarks(BenchmarkRunner& a_runner)
+{
+  World world = chapter_7_world();
+  // the same room with a floor and walls of planes rather than spheres
+  World planes_world = chapter_9_world();
+  const int sizes[][2] = {{160, 90}, {640, 360}, {1920, 1080}};
+  for (auto& size : sizes)
+  {
+    Camera camera = chapter_7_camera(size[0], size[1]);
+    std::string resolution =
+        std::to_string(size[0]) + "x" + std::to_string(size[1]);
+    a_runner.run("render_chapter_7_" + resolution, [&]()
+    {
+      keep(camera.render(world).pixel_at(0, 0).red());
+    }, size[0] * size[1]);
+    a_runner.run("render_chapter_9_" + resolution, [&]()
+    {
+      keep(camera.render(planes_world).pixel_at(0, 0).red());
+    }, size[0] * size[1]);
+
+    for (int packet_size : {4, 8, 16})
+    {
+      camera.set_packet_size(packet_size);
+      a_runner.run("render_chapter_7_" + resolution + "_packet" +
+                   std::to_string(packet_size), [&]()
+      {
+        keep(camera.render(world).pixel_at(0, 0).red());
+      }, size[0] * size[1]);
+    }
+    camera.set_packet_size(1);
+
+    a_runner.run("render_chapter_7_" + resolution + "_progressive", [&]()
+    {
+      keep(camera.render_progressive(world, Camera::PassDoneCallback())
+               .pixel_at(0, 0).red());
+    }, size[0] * size[1]);
+
+    camera.set_shadow_cache(false);
+    a_runner.run("render_chapter_7_" + resolution + "_no_shadow_cache", [&]()
+    {
+      keep(camera.render(world).pixel_at(0, 0).red());
+    }, size[0] * size[1]);
+    camera.set_shadow_cache(true);
+
+    trace::set_enabled(true);
+    a_runner.run("render_chapter_7_" + resolution + "_traced", [&]()
+    {
+      keep(camera.render(world).pixel_at(0, 0).red());
+      trace::clear();
+    }, size[0] * size[1]);
+    trace::set_enabled(false);
+
+    camera.set_thread_count(hardware_thread_count());
+    a_runner.run("render_chapter_7_" + resolution + "_threaded", [&]()
+    {
+      keep(camera.render(world).pixel_at(0, 0).red());
+    }, size[0] * size[1]);
+  }
+}
+
+} // namespace
+
+/// Run the raytracer benchmarks and write their timings as JSON.
+/// Usage: raytracer_bench [name_filter] [min_seconds_per_benchmark]
+int main(int argc, char* argv[])
+{
+  std::string filter = argc > 1 ? argv[1] : "";
+  double min_seconds = argc > 2 ? std::atof(argv[2]) : 0.25;
+  BenchmarkRunner runner(filter, min_seconds);
+
+  math_benchmarks(runner);
+  kernel_benchmarks(runner);
+  intersect_benchmarks(runner);
+  shading_benchmarks(runner);
+  output_benchmarks(runner);
+  scene_benchmarks(runner);
+  render_benchmarks(runner);
+
+  runner.write_json(std::cout);
+  return 0;
+}
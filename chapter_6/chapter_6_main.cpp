@@ -44,7 +44,7 @@ int main(int argc, char* argv[])
         Tuple point = ray.position(intersection->t());
         Tuple normal = intersection->object().normal_at(point);
         Tuple eyeVector = -ray.direction();
-        Color color = lighting(intersection->object().material(), light, point, eyeVector, normal);
+        Color color = lighting(intersection->object().material(), light, point, eyeVector, normal, false);
         canvas.write_pixel(h, v, color);
       }
       else
@@ -0,0 +1,65 @@
+#include <raytracer/bounds.h>
+
+#include <algorithm>
+
+#include <raytracer/matrix.h>
+
+
+//------------------------------------------------------------------------------
+void Bounds::extend(const Tuple& a_point)
+{
+  minimum_ = point(std::min(minimum_.x(), a_point.x()),
+                   std::min(minimum_.y(), a_point.y()),
+                   std::min(minimum_.z(), a_point.z()));
+  maximum_ = point(std::max(maximum_.x(), a_point.x()),
+                   std::max(maximum_.y(), a_point.y()),
+                   std::max(maximum_.z(), a_point.z()));
+}
+
+//------------------------------------------------------------------------------
+void Bounds::extend(const Bounds& a_bounds)
+{
+  if (a_bounds.is_empty())
+    return;
+  extend(a_bounds.minimum_);
+  extend(a_bounds.maximum_);
+}
+
+//------------------------------------------------------------------------------
+Tuple Bounds::centroid() const
+{
+  return point((minimum_.x() + maximum_.x()) / 2,
+               (minimum_.y() + maximum_.y()) / 2,
+               (minimum_.z() + maximum_.z()) / 2);
+}
+
+//------------------------------------------------------------------------------
+Scalar Bounds::surface_area() const
+{
+  if (is_empty())
+    return 0.0;
+  Tuple size = maximum_ - minimum_;
+  return 2 * (size.x() * size.y() + size.y() * size.z() + size.z() * size.x());
+}
+
+//------------------------------------------------------------------------------
+Bounds Bounds::transform(const Matrix& a_transform) const
+{
+  Bounds result;
+  if (is_empty())
+    return result;
+  for (int corner = 0; corner < 8; ++corner)
+  {
+    Tuple p = point((corner & 1) ? maximum_.x() : minimum_.x(),
+                    (corner & 2) ? maximum_.y() : minimum_.y(),
+                    (corner & 4) ? maximum_.z() : minimum_.z());
+    result.extend(a_transform * p);
+  }
+  return result;
+}
+
+//------------------------------------------------------------------------------
+Tuple inverse_direction(const Tuple& a_direction)
+{
+  return vector(1 / a_direction.x(), 1 / a_direction.y(), 1 / a_direction.z());
+}
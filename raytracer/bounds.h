@@ -0,0 +1,121 @@
+#pragma once
+
+#include <limits>
+#include <utility>
+
+#include <raytracer/tuple.h>
+
+
+class Matrix;
+
+/// An axis aligned bounding box.
+class Bounds
+{
+public:
+  /// Construct an empty bounding box that contains no points.
+  Bounds()
+      : minimum_(point(std::numeric_limits<Scalar>::infinity(),
+                       std::numeric_limits<Scalar>::infinity(),
+                       std::numeric_limits<Scalar>::infinity()))
+        , maximum_(point(-std::numeric_limits<Scalar>::infinity(),
+                         -std::numeric_limits<Scalar>::infinity(),
+                         -std::numeric_limits<Scalar>::infinity()))
+  {
+  }
+
+  /// Construct a bounding box from its corners.
+  /// \param a_minimum The corner with the smallest coordinates.
+  /// \param a_maximum The corner with the largest coordinates.
+  Bounds(const Tuple& a_minimum, const Tuple& a_maximum)
+      : minimum_(a_minimum)
+        , maximum_(a_maximum)
+  {
+  }
+
+  /// Get the corner with the smallest coordinates.
+  /// \return The minimum corner point.
+  const Tuple& minimum() const
+  {
+    return minimum_;
+  }
+
+  /// Get the corner with the largest coordinates.
+  /// \return The maximum corner point.
+  const Tuple& maximum() const
+  {
+    return maximum_;
+  }
+
+  /// Determine if the bounding box contains no points.
+  /// \return True if the bounding box is empty.
+  bool is_empty() const
+  {
+    return minimum_.x() > maximum_.x();
+  }
+
+  /// Grow the bounding box to contain a point.
+  /// \param a_point The point to contain.
+  void extend(const Tuple& a_point);
+
+  /// Grow the bounding box to contain another bounding box.
+  /// \param a_bounds The bounding box to contain.
+  void extend(const Bounds& a_bounds);
+
+  /// Get the center of the bounding box.
+  /// \return The center point.
+  Tuple centroid() const;
+
+  /// Get the surface area of the bounding box.
+  /// \return The surface area (0 for an empty box).
+  Scalar surface_area() const;
+
+  /// Transform the bounding box.
+  /// \param a_transform The transformation matrix.
+  /// \return A bounding box containing the transformed box.
+  Bounds transform(const Matrix& a_transform) const;
+
+  /// Determine if a ray passes through the bounding box.
+  /// \param a_origin The origin of the ray.
+  /// \param a_inverse_direction One over each ray direction component.
+  /// \param a_t_min The smallest distance along the ray to consider.
+  /// \param a_t_max The largest distance along the ray to consider.
+  /// \return True if the ray enters the box between the two distances.
+  bool intersects(const Tuple& a_origin, const Tuple& a_inverse_direction,
+      Scalar a_t_min, Scalar a_t_max) const
+  {
+    Scalar t_enter = a_t_min;
+    Scalar t_exit = a_t_max;
+    clip_slab(minimum_.x(), maximum_.x(), a_origin.x(), a_inverse_direction.x(),
+              t_enter, t_exit);
+    clip_slab(minimum_.y(), maximum_.y(), a_origin.y(), a_inverse_direction.y(),
+              t_enter, t_exit);
+    clip_slab(minimum_.z(), maximum_.z(), a_origin.z(), a_inverse_direction.z(),
+              t_enter, t_exit);
+    return t_enter <= t_exit;
+  }
+
+private:
+  /// Narrow a ray distance range to where it is between two parallel planes.
+  /// A ray lying in one of the planes gives NaN distances, which the
+  /// comparisons ignore so the range is left unchanged.
+  static void clip_slab(Scalar a_minimum, Scalar a_maximum, Scalar a_origin,
+      Scalar a_inverse_direction, Scalar& a_t_enter, Scalar& a_t_exit)
+  {
+    Scalar t_near = (a_minimum - a_origin) * a_inverse_direction;
+    Scalar t_far = (a_maximum - a_origin) * a_inverse_direction;
+    if (t_near > t_far)
+      std::swap(t_near, t_far);
+    if (t_near > a_t_enter)
+      a_t_enter = t_near;
+    if (t_far < a_t_exit)
+      a_t_exit = t_far;
+  }
+
+  Tuple minimum_; ///< The corner with the smallest coordinates.
+  Tuple maximum_; ///< The corner with the largest coordinates.
+};
+
+/// Get the inverse of a ray direction for bounding box tests.
+/// \param a_direction The ray direction.
+/// \return One over each component of the direction.
+Tuple inverse_direction(const Tuple& a_direction);
@@ -0,0 +1,172 @@
+#include <raytracer/bvh.h>
+
+#include <algorithm>
+
+
+namespace
+{
+const int BIN_COUNT = 12;      ///< Number of buckets to evaluate splits with.
+const int MAX_LEAF_SIZE = 4;   ///< Largest leaf kept when a split is no better.
+const int MAX_SAH_DEPTH = 32;  ///< Depth after which nodes are split in half.
+
+//------------------------------------------------------------------------------
+double axis_value(const Tuple& a_tuple, int a_axis)
+{
+  return a_axis == 0 ? a_tuple.x() : a_axis == 1 ? a_tuple.y() : a_tuple.z();
+}
+} // namespace
+
+//------------------------------------------------------------------------------
+void Bvh::build(const std::vector<Bounds>& a_bounds)
+{
+  clear();
+  if (a_bounds.empty())
+    return;
+
+  std::vector<Tuple> centroids;
+  centroids.reserve(a_bounds.size());
+  for (size_t i = 0; i < a_bounds.size(); ++i)
+  {
+    centroids.push_back(a_bounds[i].centroid());
+    objects_.push_back(static_cast<int>(i));
+  }
+  nodes_.reserve(2 * a_bounds.size());
+  build_node(a_bounds, centroids, 0, static_cast<int>(a_bounds.size()), 0);
+}
+
+//------------------------------------------------------------------------------
+void Bvh::assign(const BvhNode* a_nodes, int a_node_count,
+    const int* a_objects, int a_object_count)
+{
+  nodes_.assign(a_nodes, a_nodes + a_node_count);
+  objects_.assign(a_objects, a_objects + a_object_count);
+}
+
+//------------------------------------------------------------------------------
+void Bvh::clear()
+{
+  nodes_.clear();
+  objects_.clear();
+}
+
+//------------------------------------------------------------------------------
+int Bvh::build_node(const std::vector<Bounds>& a_bounds,
+    const std::vector<Tuple>& a_centroids, int a_begin, int a_end, int a_depth)
+{
+  int node_index = static_cast<int>(nodes_.size());
+  nodes_.emplace_back();
+
+  Bounds bounds;
+  Bounds centroid_bounds;
+  for (int i = a_begin; i < a_end; ++i)
+  {
+    bounds.extend(a_bounds[objects_[i]]);
+    centroid_bounds.extend(a_centroids[objects_[i]]);
+  }
+  nodes_[node_index].bounds = bounds;
+  int count = a_end - a_begin;
+
+  // split along the axis the centroids are most spread out on
+  Tuple extent = centroid_bounds.maximum() - centroid_bounds.minimum();
+  int axis = 0;
+  if (extent.y() > axis_value(extent, axis))
+    axis = 1;
+  if (extent.z() > axis_value(extent, axis))
+    axis = 2;
+  double axis_min = axis_value(centroid_bounds.minimum(), axis);
+  double axis_extent = axis_value(extent, axis);
+
+  if (count <= 2 || (axis_extent <= 0 && count <= MAX_LEAF_SIZE))
+  {
+    nodes_[node_index].first = a_begin;
+    nodes_[node_index].count = count;
+    return node_index;
+  }
+
+  int middle = a_begin;
+  if (axis_extent > 0 && a_depth < MAX_SAH_DEPTH)
+  {
+    auto bin_of = [&](int a_object)
+    {
+      double offset = axis_value(a_centroids[a_object], axis) - axis_min;
+      int bin = static_cast<int>(BIN_COUNT * offset / axis_extent);
+      return std::min(bin, BIN_COUNT - 1);
+    };
+
+    Bounds bin_bounds[BIN_COUNT];
+    int bin_counts[BIN_COUNT] = {};
+    for (int i = a_begin; i < a_end; ++i)
+    {
+      int bin = bin_of(objects_[i]);
+      bin_bounds[bin].extend(a_bounds[objects_[i]]);
+      ++bin_counts[bin];
+    }
+
+    // cost of each split is the area weighted object count on either side
+    double right_areas[BIN_COUNT];
+    int right_counts[BIN_COUNT];
+    Bounds right;
+    int right_count = 0;
+    for (int bin = BIN_COUNT - 1; bin > 0; --bin)
+    {
+      right.extend(bin_bounds[bin]);
+      right_count += bin_counts[bin];
+      right_areas[bin] = right.surface_area();
+      right_counts[bin] = right_count;
+    }
+    Bounds left;
+    int left_count = 0;
+    int best_split = -1;
+    double best_cost = 0;
+    for (int split = 1; split < BIN_COUNT; ++split)
+    {
+      left.extend(bin_bounds[split - 1]);
+      left_count += bin_counts[split - 1];
+      if (left_count == 0 || right_counts[split] == 0)
+        continue;
+      double cost = left.surface_area() * left_count +
+                    right_areas[split] * right_counts[split];
+      if (best_split < 0 || cost < best_cost)
+      {
+        best_split = split;
+        best_cost = cost;
+      }
+    }
+
+    double leaf_cost = bounds.surface_area() * count;
+    if (count <= MAX_LEAF_SIZE && (best_split < 0 || best_cost >= leaf_cost))
+    {
+      nodes_[node_index].first = a_begin;
+      nodes_[node_index].count = count;
+      return node_index;
+    }
+    if (best_split > 0)
+    {
+      middle = static_cast<int>(
+          std::partition(objects_.begin() + a_begin, objects_.begin() + a_end,
+                         [&](int a_object)
+                         { return bin_of(a_object) < best_split; }) -
+          objects_.begin());
+    }
+  }
+
+  if (middle == a_begin || middle == a_end)
+  {
+    // no useful split was found, so halve the objects along the axis
+    middle = a_begin + count / 2;
+    std::nth_element(objects_.begin() + a_begin, objects_.begin() + middle,
+                     objects_.begin() + a_end, [&](int a_lhs, int a_rhs)
+                     {
+                       return axis_value(a_centroids[a_lhs], axis) <
+                              axis_value(a_centroids[a_rhs], axis);
+                     });
+  }
+
+  build_node(a_bounds, a_centroids, a_begin, middle, a_depth + 1);
+  int second_child =
+      build_node(a_bounds, a_centroids, middle, a_end, a_depth + 1);
+  nodes_[node_index].first = second_child;
+  nodes_[node_index].count = 0;
+  nodes_[node_index].axis = axis;
+  return node_index;
+}
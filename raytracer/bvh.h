@@ -0,0 +1,199 @@
+#pragma once
+
+#include <vector>
+
+#include <raytracer/bounds.h>
+#include <raytracer/ray.h>
+#include <raytracer/ray_packet.h>
+
+
+/// A node of a bounding volume hierarchy.
+struct BvhNode
+{
+  Bounds bounds;   ///< Bounds of everything below the node.
+  int first = 0;   ///< First object of a leaf, or second child of a branch.
+  int count = 0;   ///< Number of objects in a leaf (0 for a branch).
+  int axis = 0;    ///< Axis a branch was split along (0 = x, 1 = y, 2 = z).
+};
+
+/// Bounding volume hierarchy over a list of object bounds.
+///
+/// Nodes are stored depth first so the first child of a branch immediately
+/// follows it. The hierarchy is split using the surface area heuristic.
+class Bvh
+{
+public:
+  /// Number of nodes a traversal can hold waiting to be visited. A node at
+  /// depth d (the root is at depth 0) needs d + 1 of them, so no node may
+  /// be deeper than STACK_SIZE - 1. Built hierarchies stay well within it.
+  static const int STACK_SIZE = 64;
+
+  /// Build the hierarchy.
+  /// \param a_bounds The world space bounds of each object.
+  void build(const std::vector<Bounds>& a_bounds);
+
+  /// Replace the hierarchy with nodes built earlier, such as from a scene
+  /// cache.
+  /// \param a_nodes The nodes in depth first order.
+  /// \param a_node_count The number of nodes.
+  /// \param a_objects The object indices referenced by the leaves.
+  /// \param a_object_count The number of object indices.
+  void assign(const BvhNode* a_nodes, int a_node_count, const int* a_objects,
+      int a_object_count);
+
+  /// Remove the hierarchy.
+  void clear();
+
+  /// Determine if the hierarchy has been built.
+  /// \return True if there are no nodes.
+  bool empty() const
+  {
+    return nodes_.empty();
+  }
+
+  /// Get the nodes of the hierarchy.
+  /// \return The nodes with the root first.
+  const std::vector<BvhNode>& nodes() const
+  {
+    return nodes_;
+  }
+
+  /// Get the object indices referenced by the leaves.
+  /// \return The object indices in leaf order.
+  const std::vector<int>& objects() const
+  {
+    return objects_;
+  }
+
+  /// Visit the objects whose bounds a ray passes through.
+  /// \param a_ray The ray to traverse the hierarchy with.
+  /// \param a_t_min The smallest distance along the ray to consider.
+  /// \param a_t_max The largest distance along the ray to consider. The
+  /// visitor may shrink it while traversing.
+  /// \param a_visit Called with each object index. Returning false stops the
+  /// traversal.
+  template <typename Visit>
+  void traverse(const Ray& a_ray, Scalar a_t_min, const Scalar& a_t_max,
+      Visit a_visit) const;
+
+  /// Visit the objects whose bounds any ray of a packet passes through.
+  /// \param a_packet The rays to traverse the hierarchy with.
+  /// \param a_t_max The largest distance along each ray to consider. The
+  /// visitor may shrink them while traversing.
+  /// \param a_visit Called with each object index.
+  template <int N, typename Visit>
+  void traverse_packet(const RayPacket<N>& a_packet, const Scalar* a_t_max,
+      Visit a_visit) const;
+
+private:
+  int build_node(const std::vector<Bounds>& a_bounds,
+      const std::vector<Tuple>& a_centroids, int a_begin, int a_end,
+      int a_depth);
+
+  std::vector<BvhNode> nodes_; ///< Nodes in depth first order.
+  std::vector<int> objects_;   ///< Object indices referenced by the leaves.
+};
+
+//------------------------------------------------------------------------------
+template <typename Visit>
+void Bvh::traverse(const Ray& a_ray, Scalar a_t_min, const Scalar& a_t_max,
+    Visit a_visit) const
+{
+  if (nodes_.empty())
+    return;
+
+  const Tuple& origin = a_ray.origin();
+  Tuple inverse = inverse_direction(a_ray.direction());
+  int stack[STACK_SIZE];
+  int stack_size = 0;
+  stack[stack_size++] = 0;
+  while (stack_size > 0)
+  {
+    const BvhNode& node = nodes_[stack[--stack_size]];
+    if (!node.bounds.intersects(origin, inverse, a_t_min, a_t_max))
+      continue;
+    if (node.count > 0)
+    {
+      for (int i = node.first; i < node.first + node.count; ++i)
+      {
+        if (!a_visit(objects_[i]))
+          return;
+      }
+    }
+    else
+    {
+      // push the far child first so the near child is visited first
+      int first_child = static_cast<int>(&node - nodes_.data()) + 1;
+      Scalar axis_direction = node.axis == 0 ? inverse.x() :
+                              node.axis == 1 ? inverse.y() : inverse.z();
+      if (axis_direction < 0)
+      {
+        stack[stack_size++] = first_child;
+        stack[stack_size++] = node.first;
+      }
+      else
+      {
+        stack[stack_size++] = node.first;
+        stack[stack_size++] = first_child;
+      }
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+template <int N, typename Visit>
+void Bvh::traverse_packet(const RayPacket<N>& a_packet, const Scalar* a_t_max,
+    Visit a_visit) const
+{
+  if (nodes_.empty())
+    return;
+
+  Tuple origins[N];
+  Tuple inverses[N];
+  for (int lane = 0; lane < a_packet.count; ++lane)
+  {
+    Ray ray = a_packet.ray(lane);
+    origins[lane] = ray.origin();
+    inverses[lane] = inverse_direction(ray.direction());
+  }
+
+  int stack[STACK_SIZE];
+  int stack_size = 0;
+  stack[stack_size++] = 0;
+  while (stack_size > 0)
+  {
+    const BvhNode& node = nodes_[stack[--stack_size]];
+    bool any_lane = false;
+    for (int lane = 0; lane < a_packet.count && !any_lane; ++lane)
+    {
+      any_lane = node.bounds.intersects(origins[lane], inverses[lane], 0,
+                                        a_t_max[lane]);
+    }
+    if (!any_lane)
+      continue;
+    if (node.count > 0)
+    {
+      for (int i = node.first; i < node.first + node.count; ++i)
+        a_visit(objects_[i]);
+    }
+    else
+    {
+      // the rays are expected to be coherent so the first ray decides which
+      // child is near
+      int first_child = static_cast<int>(&node - nodes_.data()) + 1;
+      const Tuple& inverse = inverses[0];
+      Scalar axis_direction = node.axis == 0 ? inverse.x() :
+                              node.axis == 1 ? inverse.y() : inverse.z();
+      if (axis_direction < 0)
+      {
+        stack[stack_size++] = first_child;
+        stack[stack_size++] = node.first;
+      }
+      else
+      {
+        stack[stack_size++] = node.first;
+        stack[stack_size++] = first_child;
+      }
+    }
+  }
+}
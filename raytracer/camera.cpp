@@ -1,53 +1,80 @@
 #include <raytracer/camera.h>
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
 
+#include <raytracer/ray_packet.h>
+#include <raytracer/row_reporter.h>
+#include <raytracer/scheduler.h>
+#include <raytracer/trace.h>
+
 
 //------------------------------------------------------------------------------
-Camera::Camera(int a_h_size, int a_v_size, double a_field_of_view)
+Camera::Camera(int a_h_size, int a_v_size, Scalar a_field_of_view)
     : h_size_(a_h_size)
       , v_size_(a_v_size)
       , field_of_view_(a_field_of_view)
       , transform_(Matrix::identity_matrix())
+      , inverse_transform_(Matrix::identity_matrix())
       , half_width_(0.0)
       , half_height_(0.0)
       , pixel_size_(0.0)
+      , thread_count_(1)
+      , tile_size_(16)
+      , packet_size_(1)
+      , shadow_cache_(true)
 {
   calculate_pixel_data();
 }
 
 //------------------------------------------------------------------------------
-double Camera::pixel_size() const
+Scalar Camera::pixel_size() const
 {
   return pixel_size_;
 }
 
 //------------------------------------------------------------------------------
-Ray Camera::ray_for_pixel(double a_px, double a_py) const
+Ray Camera::ray_for_pixel(Scalar a_px, Scalar a_py) const
 {
   // the offset from the edge of the canvas to the pixel's center
-  double x_offset = (a_px + 0.5) * pixel_size();
-  double y_offset = (a_py + 0.5) * pixel_size();
+  Scalar x_offset = (a_px + 0.5) * pixel_size();
+  Scalar y_offset = (a_py + 0.5) * pixel_size();
 
   // the untransformed coordinates of the pixel in world space.
   // (remember that the camera looks toward -z_, so +x_ is to the *left*.)
-  double world_x = half_width_ - x_offset;
-  double world_y = half_height_ - y_offset;
+  Scalar world_x = half_width_ - x_offset;
+  Scalar world_y = half_height_ - y_offset;
 
   // using the camera matrix, set_transform the canvas point and the origin,
   // and then compute the ray's direction vector.
   // (remember that the canvas is at z_=-1)
-  Tuple pixel = transform().inverse() * point(world_x, world_y, -1);
-  Tuple origin = transform().inverse() * point(0, 0, 0);
-  Tuple direction = (pixel - origin).normalize();
-  return {origin, direction};
+  Tuple pixel = inverse_transform_ * point(world_x, world_y, -1);
+  Tuple direction = (pixel - origin_).normalize();
+  return {origin_, direction};
+}
+
+//------------------------------------------------------------------------------
+void Camera::ray_directions(int a_px_begin, int a_py_begin, int a_px_end,
+    int a_py_end, std::vector<Tuple>& a_directions) const
+{
+  a_directions.clear();
+  for (int y = a_py_begin; y < a_py_end; ++y)
+  {
+    Tuple row_pixel = first_pixel_ + pixel_step_y_ * y;
+    for (int x = a_px_begin; x < a_px_end; ++x)
+    {
+      Tuple pixel = row_pixel + pixel_step_x_ * x;
+      a_directions.push_back((pixel - origin_).normalize());
+    }
+  }
 }
 
 //------------------------------------------------------------------------------
 void Camera::calculate_pixel_data()
 {
-  double half_view = tan(field_of_view_ / 2);
-  double aspect = (double) h_size_ / v_size_;
+  Scalar half_view = std::tan(field_of_view_ / 2);
+  Scalar aspect = (Scalar) h_size_ / v_size_;
   if (aspect >= 1)
   {
     half_width_ = half_view;
@@ -60,20 +87,249 @@ void Camera::calculate_pixel_data()
   }
 
   pixel_size_ = (half_width_ * 2) / h_size_;
+  calculate_view_data();
+}
+
+//------------------------------------------------------------------------------
+void Camera::calculate_view_data()
+{
+  // the canvas is an affine image of the pixel grid, so neighbouring pixel
+  // centers are a fixed world space offset apart
+  inverse_transform_ = transform_.inverse();
+  origin_ = inverse_transform_ * point(0, 0, 0);
+  Scalar half_pixel = pixel_size_ / 2;
+  first_pixel_ = inverse_transform_ *
+                 point(half_width_ - half_pixel, half_height_ - half_pixel, -1);
+  pixel_step_x_ = inverse_transform_ * vector(-pixel_size_, 0, 0);
+  pixel_step_y_ = inverse_transform_ * vector(0, -pixel_size_, 0);
 }
 
 //------------------------------------------------------------------------------
 Canvas Camera::render(const World& a_world) const
 {
+  return render(a_world, RowsDoneCallback());
+}
+
+//------------------------------------------------------------------------------
+Canvas Camera::render(const World& a_world,
+    const RowsDoneCallback& a_rows_done,
+    ShadowCacheStats* a_shadow_stats) const
+{
+  return render_tiles(a_world, a_rows_done, a_shadow_stats, nullptr);
+}
+
+//------------------------------------------------------------------------------
+RenderResult Camera::render_with_stats(const World& a_world,
+    const RowsDoneCallback& a_rows_done) const
+{
+  RenderStats stats;
+  Canvas image = render_tiles(a_world, a_rows_done, nullptr, &stats);
+  return RenderResult{std::move(image), stats};
+}
+
+//------------------------------------------------------------------------------
+Canvas Camera::render_tiles(const World& a_world,
+    const RowsDoneCallback& a_rows_done, ShadowCacheStats* a_shadow_stats,
+    RenderStats* a_stats) const
+{
+  trace::Span span("render");
+  auto start = std::chrono::steady_clock::now();
+  bool gather_stats = RenderStats::enabled && a_stats;
   Canvas image(h_size_, v_size_);
-  for (int y = 0; y < v_size_; ++y)
+  int tiles_across = (h_size_ + tile_size_ - 1) / tile_size_;
+  int tiles_down = (v_size_ + tile_size_ - 1) / tile_size_;
+
+  RowReporter row_reporter(tiles_across, tile_size_, v_size_,
+                           [&](int a_rows)
   {
-    for (int x = 0; x < h_size_; ++x)
+    stats::ScopedPhase output(&RenderStats::output_seconds);
+    a_rows_done(image, a_rows);
+  });
+
+  Scheduler scheduler(thread_count_);
+  std::vector<ShadowCache> shadow_caches(scheduler.thread_count());
+  std::vector<RenderStats> worker_stats(scheduler.thread_count());
+  if (gather_stats)
+  {
+    std::chrono::duration<double> setup_time =
+        std::chrono::steady_clock::now() - start;
+    worker_stats[0].setup_seconds = setup_time.count();
+  }
+  scheduler.run(tiles_across * tiles_down, [&](int a_tile, int a_worker)
+  {
+    // leave out anything the thread counted before this tile
+    if (gather_stats)
+      stats::take();
+    int x = (a_tile % tiles_across) * tile_size_;
+    int y = (a_tile / tiles_across) * tile_size_;
+    ShadowCache* shadow_cache =
+        shadow_cache_ ? &shadow_caches[a_worker] : nullptr;
     {
-      Ray ray = ray_for_pixel(x, y);
-      Color color = a_world.color_at(ray);
-      image.write_pixel(x, y, color);
+      trace::Span tile_span("tile");
+      render_tile(a_world, image.view(x, y, tile_size_, tile_size_),
+                  shadow_cache);
     }
+
+    if (a_rows_done)
+      row_reporter.tile_done(a_tile / tiles_across);
+    if (gather_stats)
+      worker_stats[a_worker].merge(stats::take());
+  });
+
+  if (a_shadow_stats)
+  {
+    *a_shadow_stats = ShadowCacheStats();
+    for (const ShadowCache& cache : shadow_caches)
+      a_shadow_stats->merge(cache.stats);
+  }
+  if (gather_stats)
+  {
+    *a_stats = RenderStats();
+    for (const RenderStats& thread_stats : worker_stats)
+      a_stats->merge(thread_stats);
+  }
+  return image;
+}
+
+//------------------------------------------------------------------------------
+Canvas Camera::render_progressive(const World& a_world,
+    const PassDoneCallback& a_pass_done) const
+{
+  trace::Span span("render progressive");
+  Canvas image(h_size_, v_size_);
+
+  // threads render bands of whole coarse blocks so that filling a block
+  // never writes pixels of another band
+  const int coarsest_step = 4;
+  int band_height =
+      (tile_size_ + coarsest_step - 1) / coarsest_step * coarsest_step;
+  int band_count = (v_size_ + band_height - 1) / band_height;
+
+  Scheduler scheduler(thread_count_);
+  std::vector<ShadowCache> shadow_caches(scheduler.thread_count());
+  for (int step = coarsest_step; step >= 1; step /= 2)
+  {
+    scheduler.run(band_count, [&](int a_band, int a_worker)
+    {
+      trace::Span band_span("band");
+      ShadowCache* shadow_cache =
+          shadow_cache_ ? &shadow_caches[a_worker] : nullptr;
+      int y_end = std::min((a_band + 1) * band_height, v_size_);
+      for (int y = a_band * band_height; y < y_end; y += step)
+      {
+        // the same steps as ray_directions() so pixels match render()
+        Tuple row_pixel = first_pixel_ + pixel_step_y_ * y;
+        for (int x = 0; x < h_size_; x += step)
+        {
+          // skip pixels traced by the previous pass
+          if (step < coarsest_step && x % (2 * step) == 0 &&
+              y % (2 * step) == 0)
+          {
+            continue;
+          }
+
+          Tuple pixel = row_pixel + pixel_step_x_ * x;
+          Ray ray(origin_, (pixel - origin_).normalize());
+          Color color = a_world.color_at(ray, shadow_cache);
+          CanvasView block = image.view(x, y, step, step);
+          for (int v = 0; v < block.height(); ++v)
+            std::fill(block.row(v), block.row(v) + block.width(), color);
+        }
+      }
+    });
+
+    if (a_pass_done)
+      a_pass_done(image, step);
   }
   return image;
 }
+
+//------------------------------------------------------------------------------
+void Camera::render_tile(const World& a_world, const CanvasView& a_tile,
+    ShadowCache* a_shadow_cache) const
+{
+  switch (packet_size_)
+  {
+    case 4:
+      render_tile_packets<4>(a_world, a_tile, a_shadow_cache);
+      return;
+    case 8:
+      render_tile_packets<8>(a_world, a_tile, a_shadow_cache);
+      return;
+    case 16:
+      render_tile_packets<16>(a_world, a_tile, a_shadow_cache);
+      return;
+    default:
+      break;
+  }
+
+  std::vector<Tuple> directions;
+  ray_directions(a_tile.x(), a_tile.y(), a_tile.x() + a_tile.width(),
+                 a_tile.y() + a_tile.height(), directions);
+  stats::count(&RenderStats::primary_rays,
+               static_cast<long long>(directions.size()));
+
+  // each row is traced and then shaded, giving the same colors as color_at()
+  std::vector<const Shape*> objects(a_tile.width());
+  std::vector<Scalar> t(a_tile.width());
+  for (int v = 0; v < a_tile.height(); ++v)
+  {
+    const Tuple* row_directions = &directions[v * a_tile.width()];
+    {
+      stats::ScopedPhase trace(&RenderStats::trace_seconds);
+      for (int h = 0; h < a_tile.width(); ++h)
+      {
+        objects[h] =
+            a_world.closest_hit(Ray(origin_, row_directions[h]), t[h]);
+      }
+    }
+
+    stats::ScopedPhase shade(&RenderStats::shade_seconds);
+    Color* row = a_tile.row(v);
+    for (int h = 0; h < a_tile.width(); ++h)
+    {
+      row[h] = a_world.color_for_hit(Ray(origin_, row_directions[h]),
+                                     objects[h], t[h], a_shadow_cache);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+template <int N>
+void Camera::render_tile_packets(const World& a_world,
+    const CanvasView& a_tile, ShadowCache* a_shadow_cache) const
+{
+  std::vector<Tuple> directions;
+  ray_directions(a_tile.x(), a_tile.y(), a_tile.x() + a_tile.width(),
+                 a_tile.y() + a_tile.height(), directions);
+  stats::count(&RenderStats::primary_rays,
+               static_cast<long long>(directions.size()));
+
+  // packets take consecutive pixels in row order, wrapping onto the next row
+  // of the tile when a row is not a multiple of N wide
+  RayPacket<N> packet;
+  const Shape* objects[N];
+  Scalar t[N];
+  int pixel_count = static_cast<int>(directions.size());
+  for (int first = 0; first < pixel_count; first += N)
+  {
+    packet.count = std::min(N, pixel_count - first);
+    for (int lane = 0; lane < packet.count; ++lane)
+      packet.set(lane, Ray(origin_, directions[first + lane]));
+    packet.pad();
+
+    {
+      stats::ScopedPhase trace(&RenderStats::trace_seconds);
+      a_world.closest_hits(packet, objects, t);
+    }
+
+    stats::ScopedPhase shade(&RenderStats::shade_seconds);
+    for (int lane = 0; lane < packet.count; ++lane)
+    {
+      int pixel = first + lane;
+      a_tile.at(pixel % a_tile.width(), pixel / a_tile.width()) =
+          a_world.color_for_hit(packet.ray(lane), objects[lane], t[lane],
+                                a_shadow_cache);
+    }
+  }
+}
@@ -1,20 +1,45 @@
 #pragma once
 
+#include <algorithm>
+#include <functional>
+#include <vector>
+
 #include <raytracer/canvas.h>
 #include <raytracer/matrix.h>
 #include <raytracer/ray.h>
+#include <raytracer/render_stats.h>
 #include <raytracer/world.h>
 
 
+/// The canvas of a render and the statistics gathered while rendering it.
+struct RenderResult
+{
+  Canvas canvas;     ///< The canvas of rendered pixels.
+  RenderStats stats; ///< Counts and phase times (zero unless enabled).
+};
+
 /// Camera describing where the world will be rendered from.
 class Camera
 {
 public:
+  /// Called while rendering each time more rows of the canvas are complete.
+  /// Given the canvas and one past the last complete row. Calls are made one
+  /// at a time with the rows in order, from a render thread that holds no
+  /// lock, so the other threads keep rendering during a slow call.
+  typedef std::function<void(const Canvas&, int)> RowsDoneCallback;
+
+  /// Called while rendering progressively each time a pass over the canvas is
+  /// complete. Given the canvas and the step of the pass: every pixel whose
+  /// row and column are multiples of the step has been traced, and the rest
+  /// of its step by step block shows the same color. The last pass has a
+  /// step of 1 and completes the canvas.
+  typedef std::function<void(const Canvas&, int)> PassDoneCallback;
+
   /// Construct a camera.
   /// \param a_h_size The horizontal size in pixels.
   /// \param a_v_size The vertical size in pixels.
   /// \param a_field_of_view The field of view in radians.
-  Camera(int a_h_size, int a_v_size, double a_field_of_view);
+  Camera(int a_h_size, int a_v_size, Scalar a_field_of_view);
 
   /// Get the horizontal size.
   /// \return The horizontal size in pixels.
@@ -46,14 +71,14 @@ public:
 
   /// Get the field of view.
   /// \return The field of view.
-  double field_of_view() const
+  Scalar field_of_view() const
   {
     return field_of_view_;
   }
 
   /// Set the field of view.
   /// \param a_field_of_view The field of view.
-  void set_field_of_view(double a_field_of_view)
+  void set_field_of_view(Scalar a_field_of_view)
   {
     field_of_view_ = a_field_of_view;
   }
@@ -70,31 +95,163 @@ public:
   void set_transform(const Matrix& a_transform)
   {
     transform_ = a_transform;
+    calculate_view_data();
+  }
+
+  /// Get the world space position of the camera eye.
+  /// \return The origin of every ray cast from the camera.
+  const Tuple& origin() const
+  {
+    return origin_;
+  }
+
+  /// Get the number of threads used to render.
+  /// \return The number of render threads.
+  int thread_count() const
+  {
+    return thread_count_;
+  }
+
+  /// Set the number of threads used to render.
+  /// \param a_thread_count The number of render threads.
+  void set_thread_count(int a_thread_count)
+  {
+    thread_count_ = a_thread_count;
+  }
+
+  /// Get the width and height of the square tiles rendered by each thread.
+  /// \return The tile size in pixels.
+  int tile_size() const
+  {
+    return tile_size_;
+  }
+
+  /// Set the width and height of the square tiles rendered by each thread.
+  /// \param a_tile_size The tile size in pixels. Sizes below 1 are treated
+  ///                    as 1.
+  void set_tile_size(int a_tile_size)
+  {
+    tile_size_ = std::max(a_tile_size, 1);
+  }
+
+  /// Get the number of primary rays traced together as a packet.
+  /// \return 1 when rays are traced one at a time, otherwise 4, 8 or 16.
+  int packet_size() const
+  {
+    return packet_size_;
+  }
+
+  /// Set the number of primary rays traced together as a packet.
+  /// Packets give the same image as tracing rays one at a time.
+  /// \param a_packet_size 4, 8 or 16 to trace packets, anything else to
+  /// trace rays one at a time.
+  void set_packet_size(int a_packet_size)
+  {
+    bool packets = a_packet_size == 4 || a_packet_size == 8 ||
+                   a_packet_size == 16;
+    packet_size_ = packets ? a_packet_size : 1;
+  }
+
+  /// Determine if each render thread remembers the last object that blocked
+  /// a shadow ray and tests it first.
+  /// \return True if shadow caches are used.
+  bool shadow_cache() const
+  {
+    return shadow_cache_;
+  }
+
+  /// Set if each render thread remembers the last object that blocked a
+  /// shadow ray and tests it first. The image is the same either way.
+  /// \param a_shadow_cache True to use shadow caches.
+  void set_shadow_cache(bool a_shadow_cache)
+  {
+    shadow_cache_ = a_shadow_cache;
   }
 
   /// Get the world size of a pixel.
   /// \return The world size of a pixel.
-  double pixel_size() const;
+  Scalar pixel_size() const;
 
   /// Build a ray from the camera eye through a pixel.
   /// \param a_px The X coordinate of the pixel.
   /// \param a_py The Y coordinate of the pixel.
   /// \return The ray from the camera eye through the given pixel.
-  Ray ray_for_pixel(double a_px, double a_py) const;
+  Ray ray_for_pixel(Scalar a_px, Scalar a_py) const;
+
+  /// Build the ray directions from the camera eye through a block of pixels.
+  /// Directions are stepped from the first pixel rather than transformed one
+  /// at a time, and are stored row by row. All of the rays start at origin().
+  /// \param a_px_begin The X coordinate of the first pixel column.
+  /// \param a_py_begin The Y coordinate of the first pixel row.
+  /// \param a_px_end One past the X coordinate of the last pixel column.
+  /// \param a_py_end One past the Y coordinate of the last pixel row.
+  /// \param a_directions Receives the normalized ray directions.
+  void ray_directions(int a_px_begin, int a_py_begin, int a_px_end,
+      int a_py_end, std::vector<Tuple>& a_directions) const;
 
   /// Render the world.
+  /// The canvas is split into tiles which are shared between the render
+  /// threads. The result is the same for any number of threads.
   /// \param a_world The world to render.
   /// \return The canvas of rendered pixels.
   Canvas render(const World& a_world) const;
 
+  /// Render the world, reporting rows as they are completed.
+  /// \param a_world The world to render.
+  /// \param a_rows_done Called as rows are completed (may be empty).
+  /// \param a_shadow_stats Optionally receives the shadow cache counts of all
+  /// of the render threads.
+  /// \return The canvas of rendered pixels.
+  Canvas render(const World& a_world, const RowsDoneCallback& a_rows_done,
+      ShadowCacheStats* a_shadow_stats = nullptr) const;
+
+  /// Render the world, gathering statistics of the render when the library
+  /// is built with the RAYTRACER_STATS CMake option. The phase times of the
+  /// render threads are summed, so with several threads they can add up to
+  /// more than the wall time.
+  /// \param a_world The world to render.
+  /// \param a_rows_done Called as rows are completed (may be empty).
+  /// \return The canvas of rendered pixels and the statistics.
+  RenderResult render_with_stats(const World& a_world,
+      const RowsDoneCallback& a_rows_done = RowsDoneCallback()) const;
+
+  /// Render the world in passes of increasing resolution so that a preview
+  /// is available early. The first pass traces one pixel in 16 (a step of
+  /// 4), the next one in 4 (a step of 2), and the last the rest. No pixel
+  /// is traced twice, and the final canvas is the same as render() gives.
+  /// \param a_world The world to render.
+  /// \param a_pass_done Called with the canvas, not a copy, after each pass
+  /// (may be empty).
+  /// \return The canvas of rendered pixels.
+  Canvas render_progressive(const World& a_world,
+      const PassDoneCallback& a_pass_done) const;
+
 private:
   void calculate_pixel_data();
+  void calculate_view_data();
+  Canvas render_tiles(const World& a_world,
+      const RowsDoneCallback& a_rows_done, ShadowCacheStats* a_shadow_stats,
+      RenderStats* a_stats) const;
+  void render_tile(const World& a_world, const CanvasView& a_tile,
+      ShadowCache* a_shadow_cache) const;
+  template <int N>
+  void render_tile_packets(const World& a_world, const CanvasView& a_tile,
+      ShadowCache* a_shadow_cache) const;
 
-  int h_size_;            ///< The horizontal size in pixels.
-  int v_size_;            ///< The vertical size in pixels.
-  double field_of_view_;  ///< The field of view.
-  Matrix transform_;      ///< The world transformation matrix.
-  double half_width_;     ///< Half the width of the view.
-  double half_height_;    ///< Half the height of the view.
-  double pixel_size_;     ///< The world size of a pixel.
+  int h_size_;               ///< The horizontal size in pixels.
+  int v_size_;               ///< The vertical size in pixels.
+  Scalar field_of_view_;     ///< The field of view.
+  Matrix transform_;         ///< The world transformation matrix.
+  Matrix inverse_transform_; ///< The inverse world transformation matrix.
+  Tuple origin_;             ///< The world space position of the eye.
+  Tuple first_pixel_;        ///< The world space center of pixel (0, 0).
+  Tuple pixel_step_x_;       ///< The world space offset to the next column.
+  Tuple pixel_step_y_;       ///< The world space offset to the next row.
+  Scalar half_width_;        ///< Half the width of the view.
+  Scalar half_height_;       ///< Half the height of the view.
+  Scalar pixel_size_;        ///< The world size of a pixel.
+  int thread_count_;         ///< The number of render threads.
+  int tile_size_;            ///< The width and height of a render tile.
+  int packet_size_;          ///< The number of primary rays per packet.
+  bool shadow_cache_;        ///< Remember the last shadowing object.
 };
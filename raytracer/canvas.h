@@ -1,11 +1,91 @@
 #pragma once
 
 #include <raytracer/color.h>
+#include <raytracer/ppm_writer.h>
 
 #include <fstream>
 #include <vector>
 
 
+/// A rectangular window onto the pixels of a Canvas.
+///
+/// Views are cheap to copy and only refer to the canvas storage, so they must
+/// not outlive the canvas. Pixel coordinates are relative to the view.
+class CanvasView
+{
+public:
+  /// Construct a view.
+  /// \param a_pixels The first pixel of the canvas.
+  /// \param a_stride The number of pixels in a canvas row.
+  /// \param a_x The horizontal position of the view on the canvas.
+  /// \param a_y The vertical position of the view on the canvas.
+  /// \param a_width The number of pixels in horizontal direction.
+  /// \param a_height The number of pixels in the vertical direction.
+  CanvasView(Color* a_pixels, int a_stride, int a_x, int a_y, int a_width,
+      int a_height)
+      : pixels_(a_pixels + a_y * a_stride + a_x)
+        , stride_(a_stride)
+        , x_(a_x)
+        , y_(a_y)
+        , width_(a_width)
+        , height_(a_height)
+  {
+  }
+
+  /// Get the horizontal position of the view on the canvas.
+  /// \return The canvas column of the first view column.
+  int x() const
+  {
+    return x_;
+  }
+
+  /// Get the vertical position of the view on the canvas.
+  /// \return The canvas row of the first view row.
+  int y() const
+  {
+    return y_;
+  }
+
+  /// Get the horizontal width of the view.
+  /// \return The horizontal width of the view.
+  int width() const
+  {
+    return width_;
+  }
+
+  /// Get the height of the view.
+  /// \return The height of the view.
+  int height() const
+  {
+    return height_;
+  }
+
+  /// Get the pixels of a row of the view.
+  /// \param a_v The vertical position of the row in the view.
+  /// \return The first of width() contiguous pixels.
+  Color* row(int a_v) const
+  {
+    return pixels_ + a_v * stride_;
+  }
+
+  /// Get a pixel of the view.
+  /// \param a_h The horizontal position of the pixel in the view.
+  /// \param a_v The vertical position of the pixel in the view.
+  /// \return The pixel.
+  Color& at(int a_h, int a_v) const
+  {
+    return pixels_[a_v * stride_ + a_h];
+  }
+
+private:
+  Color* pixels_; ///< The first pixel of the view.
+  int stride_;    ///< The number of pixels in a canvas row.
+  int x_;         ///< The horizontal position of the view on the canvas.
+  int y_;         ///< The vertical position of the view on the canvas.
+  int width_;     ///< The number of pixels in horizontal direction.
+  int height_;    ///< The number of pixels in the vertical direction.
+};
+
 /// Canvas that pixels are stored in.
 class Canvas
 {
@@ -33,13 +113,43 @@ public:
   /// \param a_h The horizontal position of the pixel.
   /// \param a_v The vertical position of the pixel.
   /// \param a_color The color to be written.
-  void write_pixel(int a_h, int a_v, const Color& a_color);
+  void write_pixel(int a_h, int a_v, const Color& a_color)
+  {
+    pixels_[a_v * width_ + a_h] = a_color;
+  }
 
   /// Get the color of a pixel.
   /// \param a_h The horizontal position of the pixel.
   /// \param a_v The vertical position of the pixel.
   /// \return The color of the pixel.
-  Color pixel_at(int a_h, int a_v) const;
+  const Color& pixel_at(int a_h, int a_v) const
+  {
+    return pixels_[a_v * width_ + a_h];
+  }
+
+  /// Get the pixel storage.
+  /// \return The first of width() * height() pixels stored row by row.
+  const Color* data() const
+  {
+    return pixels_.data();
+  }
+
+  /// Get a view of a rectangle of pixels.
+  /// The rectangle is clipped to the canvas.
+  /// \param a_x The horizontal position of the rectangle.
+  /// \param a_y The vertical position of the rectangle.
+  /// \param a_width The number of pixels in horizontal direction.
+  /// \param a_height The number of pixels in the vertical direction.
+  /// \return The view of the rectangle.
+  CanvasView view(int a_x, int a_y, int a_width, int a_height);
+
+  /// Get a view of a row of pixels.
+  /// \param a_v The vertical position of the row.
+  /// \return The view of the row.
+  CanvasView row(int a_v)
+  {
+    return view(0, a_v, width_, 1);
+  }
 
   /// Determine if all of the pixels are a given color.
   /// \param a_color The color to compare all of the pixels too.
@@ -52,7 +162,9 @@ public:
 
   /// Export canvas to PPM file.
   /// \param a_output The output stream to write the file too.
-  void to_ppm_file(std::ostream& a_output) const;
+  /// \param a_format The encoding of the pixel data.
+  void to_ppm_file(std::ostream& a_output,
+      PpmFormat a_format = PpmFormat::P3) const;
 
   /// Export canvas to PPM file.
   /// \return The PPM file contents as a string.
@@ -61,5 +173,5 @@ public:
 private:
   int width_ = 0;        ///< The number of pixels in horizontal direction.
   int height_ = 0;       ///< The number of pixels in the vertical direction.
-  std::vector<std::vector<Color>> pixels_; ///< The storage for the pixels.
+  std::vector<Color> pixels_; ///< The pixels stored row by row.
 };
@@ -14,13 +14,13 @@ namespace
 //------------------------------------------------------------------------------
 bool Color::operator==(const Color& a_rhs) const
 {
-  bool equal =
-      red_ == a_rhs.red_ && green_ == a_rhs.green_ && blue_ == a_rhs.blue_;
+  bool equal = rgb_[0] == a_rhs.rgb_[0] && rgb_[1] == a_rhs.rgb_[1] &&
+               rgb_[2] == a_rhs.rgb_[2];
   return equal;
 }
 
 //------------------------------------------------------------------------------
-Color color(double a_red, double a_green, double a_blue)
+Color color(Scalar a_red, Scalar a_green, Scalar a_blue)
 {
   return {a_red, a_green, a_blue};
 }
@@ -37,8 +37,11 @@ bool approximately_equal(const Color& a_lhs, const Color& a_rhs)
 //------------------------------------------------------------------------------
 bool nearly_equal(const Color& a_lhs, const Color& a_rhs)
 {
-  bool equal_red = equal_to_digits(a_lhs.red(), a_rhs.red(), 10);
-  bool equal_green = equal_to_digits(a_lhs.green(), a_rhs.green(), 10);
-  bool equal_blue = equal_to_digits(a_lhs.blue(), a_rhs.blue(), 10);
+  bool equal_red =
+      equal_to_digits(a_lhs.red(), a_rhs.red(), NEARLY_EQUAL_DIGITS);
+  bool equal_green =
+      equal_to_digits(a_lhs.green(), a_rhs.green(), NEARLY_EQUAL_DIGITS);
+  bool equal_blue =
+      equal_to_digits(a_lhs.blue(), a_rhs.blue(), NEARLY_EQUAL_DIGITS);
   return equal_red && equal_green && equal_blue;
 }
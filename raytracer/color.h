@@ -1,60 +1,75 @@
 #pragma once
 
+#include <raytracer/scalar.h>
+#include <raytracer/simd.h>
+
 /// A color tuple.
 class Color
 {
 public:
   /// Construct a color with default value of black.
   Color()
-      : red_()
-        , green_()
-        , blue_()
+      : rgb_()
   {
   }
 
   /// Construct a color given color components.
-  Color(double a_red, double a_green, double a_blue)
-      : red_(a_red)
-        , green_(a_green)
-        , blue_(a_blue)
+  Color(Scalar a_red, Scalar a_green, Scalar a_blue)
+      : rgb_{a_red, a_green, a_blue}
   {
   }
 
   /// Get the red component of the color.
-  double red() const
+  Scalar red() const
   {
-    return red_;
+    return rgb_[0];
   }
 
   /// Get the green component of the color.
-  double green() const
+  Scalar green() const
   {
-    return green_;
+    return rgb_[1];
   }
 
   /// Get the blue component of the color.
-  double blue() const
+  Scalar blue() const
+  {
+    return rgb_[2];
+  }
+
+  /// Get the components as an array.
+  /// \return Pointer to the red, green and blue components in that order.
+  const Scalar* data() const
   {
-    return blue_;
+    return rgb_;
+  }
+
+  /// Get the components as an array.
+  /// \return Pointer to the red, green and blue components in that order.
+  Scalar* data()
+  {
+    return rgb_;
   }
 
   /// Determine if two colors are equal.
   bool operator==(const Color& a_rhs) const;
 
 private:
-  double red_;   ///< Red component from 0.0 to 1.0
-  double green_; ///< Green component from 0.0 to 1.0
-  double blue_;  ///< Blue component from 0.0 to 1.0
+  Scalar rgb_[3]; ///< Red, green and blue components from 0.0 to 1.0
 };
 
+static_assert(sizeof(Color) == 3 * sizeof(Scalar),
+              "Color components must be packed for the simd kernels");
+
 /// Color addition operator.
 /// \param a_lhs The first operand.
 /// \param a_rhs The second operand.
 /// \return The result of adding the two colors.
 inline Color operator+(const Color& a_lhs, const Color& a_rhs)
 {
-  return {a_lhs.red() + a_rhs.red(), a_lhs.green() + a_rhs.green(),
-          a_lhs.blue() + a_rhs.blue()};
+  Color result;
+  simd::add3(a_lhs.data(), a_rhs.data(), result.data());
+  return result;
 }
 
 /// Color subtraction operator.
@@ -63,8 +78,9 @@ inline Color operator+(const Color& a_lhs, const Color& a_rhs)
 /// \return The resulting of subtracting the two colors.
 inline Color operator-(const Color& a_lhs, const Color& a_rhs)
 {
-  return {a_lhs.red() - a_rhs.red(), a_lhs.green() - a_rhs.green(),
-          a_lhs.blue() - a_rhs.blue()};
+  Color result;
+  simd::sub3(a_lhs.data(), a_rhs.data(), result.data());
+  return result;
 }
 
 /// Color multiplication operator.
@@ -73,24 +89,27 @@ inline Color operator-(const Color& a_lhs, const Color& a_rhs)
 /// \return The result of multiplying the two colors.
 inline Color operator*(const Color& a_lhs, const Color& a_rhs)
 {
-  return {a_lhs.red() * a_rhs.red(), a_lhs.green() * a_rhs.green(),
-          a_lhs.blue() * a_rhs.blue()};
+  Color result;
+  simd::mul3(a_lhs.data(), a_rhs.data(), result.data());
+  return result;
 }
 
 /// Color and scalar multiplication operator.
 /// \param a_lhs The first operand.
 /// \param a_rhs The second operand.
 /// \return The result of multiplying a color by a scalar.
-inline Color operator*(const Color& a_lhs, double a_rhs)
+inline Color operator*(const Color& a_lhs, Scalar a_rhs)
 {
-  return {a_lhs.red() * a_rhs, a_lhs.green() * a_rhs, a_lhs.blue() * a_rhs};
+  Color result;
+  simd::scale3(a_lhs.data(), a_rhs, result.data());
+  return result;
 }
 
 /// Color division operator.
 /// \param a_lhs The first operand.
 /// \param a_b The second operand.
 /// \return The result of dividing the two colors.
-inline Color operator/(const Color& a_lhs, double a_rhs)
+inline Color operator/(const Color& a_lhs, Scalar a_rhs)
 {
   return {a_lhs.red() / a_rhs, a_lhs.green() / a_rhs, a_lhs.blue() / a_rhs};
 }
@@ -22,8 +22,8 @@ const Intersection* hit(const Intersections& a_intersections)
 //------------------------------------------------------------------------------
 Computations Intersection::prepare_computations(const Ray& a_ray) const
 {
-  double t_value = t();
-  const Sphere* object_value = &object();
+  Scalar t_value = t();
+  const Shape* object_value = &object();
   Tuple point = a_ray.position(t_value);
   Tuple to_eye = -a_ray.direction();
   Tuple normal = object_value->normal_at(point);
@@ -3,14 +3,20 @@
 #include <vector>
 
 #include <raytracer/ray.h>
-#include <raytracer/sphere.h>
+#include <raytracer/shape.h>
 
 
 class Computations;
 
-class Sphere;
+class Shape;
 
-const double EPSILON = 1.0e-5;
+/// Distance points are moved off a surface so they do not hit it again.
+/// Single precision rounding needs a larger offset.
+#if defined(RAYTRACER_FLOAT)
+const Scalar EPSILON = 2.0e-3f;
+#else
+const Scalar EPSILON = 1.0e-5;
+#endif
 
 /// Data for an object and ray intersection.
 class Intersection
@@ -20,7 +26,7 @@ public:
   /// Construct an intersection.
   /// \param a_t The distance to the intersection.
   /// \param a_object The object at the intersection.
-  Intersection(double a_t, const Sphere& a_object)
+  Intersection(Scalar a_t, const Shape& a_object)
       : t_(a_t)
         , object_(&a_object)
   {
@@ -28,14 +34,14 @@ public:
 
   /// Get the distance to the intersection.
   /// \return The distance to the intersection.
-  double t() const
+  Scalar t() const
   {
     return t_;
   }
 
   /// Get the intersected object.
   /// \return The intersected object.
-  const Sphere& object() const
+  const Shape& object() const
   {
     return *object_;
   }
@@ -54,8 +60,8 @@ public:
   Computations prepare_computations(const Ray& a_ray) const;
 
 private:
-  double t_;             ///< The distance to the intersection.
-  const Sphere* object_; ///< The intersected object.
+  Scalar t_;             ///< The distance to the intersection.
+  const Shape* object_;  ///< The intersected object.
 };
 
 typedef std::vector<Intersection> Intersections;
@@ -63,8 +69,8 @@ typedef std::vector<Intersection> Intersections;
 /// Store computations for ray intersection.
 struct Computations
 {
-  double t = 0.0;                 ///< T value along ray.
-  const Sphere* object = nullptr; ///< Intersected object.
+  Scalar t = 0.0;                 ///< T value along ray.
+  const Shape* object = nullptr;  ///< Intersected object.
   Tuple point;                    ///< Point of intersection.
   Tuple to_eye;                   ///< Vector directed to eye.
   Tuple normal;                   ///< Normal vector on object surface.
@@ -12,20 +12,22 @@ Material::Material()
       , diffuse_(0.9)
       , specular_(0.9)
       , shininess_(200.0)
+      , integer_shininess_(integer_exponent(shininess_))
 {
 }
 
 //------------------------------------------------------------------------------
 Material::Material(const class Color& a_color,
-    double a_ambient,
-    double a_diffuse,
-    double a_specular,
-    double a_shininess)
+    Scalar a_ambient,
+    Scalar a_diffuse,
+    Scalar a_specular,
+    Scalar a_shininess)
     : color_(a_color)
       , ambient_(a_ambient)
       , diffuse_(a_diffuse)
       , specular_(a_specular)
       , shininess_(a_shininess)
+      , integer_shininess_(integer_exponent(shininess_))
 {
 }
 
@@ -38,7 +40,7 @@ bool Material::operator==(const Material& a_rhs) const
 }
 
 //------------------------------------------------------------------------------
-Color Material::color() const
+const Color& Material::color() const
 {
   return color_;
 }
@@ -50,51 +52,65 @@ void Material::set_color(const class Color& a_color)
 }
 
 //------------------------------------------------------------------------------
-double Material::ambient() const
+Scalar Material::ambient() const
 {
   return ambient_;
 }
 
 //------------------------------------------------------------------------------
-void Material::set_ambient(double a_ambient)
+void Material::set_ambient(Scalar a_ambient)
 {
   ambient_ = a_ambient;
 }
 
 //------------------------------------------------------------------------------
-double Material::diffuse() const
+Scalar Material::diffuse() const
 {
   return diffuse_;
 }
 
 //------------------------------------------------------------------------------
-void Material::set_diffuse(double a_diffuse)
+void Material::set_diffuse(Scalar a_diffuse)
 {
   diffuse_ = a_diffuse;
 }
 
 //------------------------------------------------------------------------------
-double Material::specular() const
+Scalar Material::specular() const
 {
   return specular_;
 }
 
 //------------------------------------------------------------------------------
-void Material::set_specular(double a_specular)
+void Material::set_specular(Scalar a_specular)
 {
   specular_ = a_specular;
 }
 
 //------------------------------------------------------------------------------
-double Material::shininess() const
+Scalar Material::shininess() const
 {
   return shininess_;
 }
 
 //------------------------------------------------------------------------------
-void Material::set_shininess(double a_shininess)
+void Material::set_shininess(Scalar a_shininess)
 {
   shininess_ = a_shininess;
+  integer_shininess_ = integer_exponent(a_shininess);
+}
+
+//------------------------------------------------------------------------------
+int Material::integer_exponent(Scalar a_shininess)
+{
+  // larger exponents need more squarings than std::pow is worth
+  const Scalar max_exponent = 1024;
+  if (a_shininess >= 0 && a_shininess <= max_exponent &&
+      std::floor(a_shininess) == a_shininess)
+  {
+    return static_cast<int>(a_shininess);
+  }
+  return -1;
 }
 
 //------------------------------------------------------------------------------
@@ -122,7 +138,7 @@ Color lighting(const Material& a_material,
   // light_dot_normal represents the cosine of the angle between the
   // light vector and the normal vector. A negative number means the
   // light is on the other side of the surface.
-  double light_dot_normal = dot(to_light, a_normal);
+  Scalar light_dot_normal = dot(to_light, a_normal);
   if (light_dot_normal < 0)
   {
     return ambient;
@@ -135,14 +151,14 @@ Color lighting(const Material& a_material,
   // reflection vector and the to_eye vector. A negative number means the
   // light reflects away from the to_eye.
   Tuple reflect_v = reflect(-to_light, a_normal);
-  double reflect_dot_eye = dot(reflect_v, a_to_eye);
+  Scalar reflect_dot_eye = dot(reflect_v, a_to_eye);
   if (reflect_dot_eye <= 0)
   {
     return ambient + diffuse;
   }
 
   // compute the specular contribution
-  double factor = pow(reflect_dot_eye, a_material.shininess());
+  Scalar factor = a_material.specular_factor(reflect_dot_eye);
   Color specular = a_light.intensity() * a_material.specular() * factor;
 
   // Add the three contributions together to get the final shading
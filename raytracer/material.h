@@ -1,6 +1,8 @@
 
 #pragma once
 
+#include <cmath>
+
 #include <raytracer/color.h>
 
 
@@ -22,10 +24,10 @@ public:
   /// \param a_specular The amount of specular light (0.0 to 1.0).
   /// \param a_shininess The shininess of the material.
   Material(const class Color& a_color,
-      double a_ambient,
-      double a_diffuse,
-      double a_specular,
-      double a_shininess);
+      Scalar a_ambient,
+      Scalar a_diffuse,
+      Scalar a_specular,
+      Scalar a_shininess);
 
   /// Equals operator.
   /// \param a_rhs The object to compare against.
@@ -34,7 +36,7 @@ public:
 
   /// Get the material color.
   /// \return The material color.
-  Color color() const;
+  const Color& color() const;
 
   /// Set the material color.
   /// \param a_color The material color.
@@ -42,42 +44,69 @@ public:
 
   /// Get the ambient value (amount of ambient light).
   /// \return The ambient value.
-  double ambient() const;
+  Scalar ambient() const;
 
   /// Set the ambient value (amount of ambient light).
   /// \param a_ambient The ambient value.
-  void set_ambient(double a_ambient);
+  void set_ambient(Scalar a_ambient);
 
   /// Get the diffuse value (light reflected from surface).
   /// \return The diffuse value.
-  double diffuse() const;
+  Scalar diffuse() const;
 
   /// Set the diffuse value (light reflected from surface).
   /// \param a_diffuse The diffuse value.
-  void set_diffuse(double a_diffuse);
+  void set_diffuse(Scalar a_diffuse);
 
   /// Get the specular value (amount of specular light 0.0 - 1.0).
   /// \return The specular value.
-  double specular() const;
+  Scalar specular() const;
 
   /// Set the specular value (how shiny).
   /// \param a_specular The specular value.
-  void set_specular(double a_specular);
+  void set_specular(Scalar a_specular);
 
   /// Get the shininess value (size of shiny spot).
   /// \return The shininess value.
-  double shininess() const;
+  Scalar shininess() const;
 
   /// Set the shininess value (size of shiny spot).
   /// \param a_shininess The shininess value.
-  void set_shininess(double a_shininess);
+  void set_shininess(Scalar a_shininess);
+
+  /// Raise the cosine between the reflected light and the eye to the
+  /// shininess. Whole number shininess up to 1024 is evaluated by repeated
+  /// squaring; other values use std::pow. Each squaring doubles the rounding
+  /// error carried so far, so the relative error from std::pow grows with the
+  /// shininess to at most about shininess * epsilon of Scalar (hundreds of ULP
+  /// at 1024, still within 1e-5 relative even for float).
+  /// \param a_reflect_dot_eye The cosine (0.0 to 1.0).
+  /// \return The specular factor.
+  Scalar specular_factor(Scalar a_reflect_dot_eye) const
+  {
+    if (integer_shininess_ < 0)
+      return std::pow(a_reflect_dot_eye, shininess_);
+
+    Scalar factor = 1;
+    Scalar power = a_reflect_dot_eye;
+    for (int exponent = integer_shininess_; exponent > 0; exponent >>= 1)
+    {
+      if (exponent & 1)
+        factor *= power;
+      power *= power;
+    }
+    return factor;
+  }
 
 private:
+  static int integer_exponent(Scalar a_shininess);
+
   class Color color_; ///< Color of the material.
-  double ambient_;    ///< Amount of ambient light (0.0 to 1.0).
-  double diffuse_;    ///< Amount of diffuse light (0.0 to 1.0).
-  double specular_;   ///< Amount of specular light (0.0 to 1.0).
-  double shininess_;  ///< Specular shininess.
+  Scalar ambient_;    ///< Amount of ambient light (0.0 to 1.0).
+  Scalar diffuse_;    ///< Amount of diffuse light (0.0 to 1.0).
+  Scalar specular_;   ///< Amount of specular light (0.0 to 1.0).
+  Scalar shininess_;  ///< Specular shininess.
+  int integer_shininess_; ///< Shininess as a whole number, or -1 if it is not.
 };
 
 /// Calculate the lighting color for an intersection.
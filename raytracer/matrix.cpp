@@ -1,4 +1,5 @@
 #include <raytracer/matrix.h>
+#include <raytracer/render_stats.h>
 #include <raytracer/test_utils.h>
 
 
@@ -9,7 +10,7 @@ MatrixRow::MatrixRow()
 }
 
 //------------------------------------------------------------------------------
-MatrixRow::MatrixRow(const std::initializer_list<double>& a_list)
+MatrixRow::MatrixRow(const std::initializer_list<Scalar>& a_list)
     : m_{}
 {
   auto it = m_.begin();
@@ -26,13 +27,13 @@ MatrixRow::MatrixRow(const std::initializer_list<double>& a_list)
 }
 
 //------------------------------------------------------------------------------
-double& MatrixRow::operator[](size_t a_col_index)
+Scalar& MatrixRow::operator[](size_t a_col_index)
 {
   return m_[a_col_index];
 }
 
 //------------------------------------------------------------------------------
-double MatrixRow::operator[](size_t a_col_index) const
+Scalar MatrixRow::operator[](size_t a_col_index) const
 {
   return m_[a_col_index];
 }
@@ -89,6 +90,34 @@ Matrix::Matrix(const std::initializer_list<MatrixRow>& a_list)
   }
 }
 
+//------------------------------------------------------------------------------
+Matrix::Matrix(const Matrix4& a_matrix)
+    : m_{}
+      , size_(4)
+{
+  for (size_t row = 0; row < 4; ++row)
+  {
+    for (size_t col = 0; col < 4; ++col)
+    {
+      m_[row][col] = a_matrix(row, col);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+Matrix4 Matrix::to_matrix4() const
+{
+  Matrix4 a;
+  for (size_t row = 0; row < 4; ++row)
+  {
+    for (size_t col = 0; col < 4; ++col)
+    {
+      a(row, col) = m_[row][col];
+    }
+  }
+  return a;
+}
+
 //------------------------------------------------------------------------------
 bool Matrix::operator==(const Matrix& a_rhs) const
 {
@@ -113,11 +142,19 @@ bool Matrix::operator!=(const Matrix& a_rhs) const
 //------------------------------------------------------------------------------
 Tuple operator*(const Matrix& a_lhs, const Tuple& a_rhs)
 {
-  double t[4] = {a_rhs.x(), a_rhs.y(), a_rhs.z(), a_rhs.w()};
-  double r[4];
+  if (a_lhs.size() == 4)
+  {
+    Tuple result;
+    simd::matrix_times4(a_lhs[0].data(), a_lhs[1].data(), a_lhs[2].data(),
+                        a_lhs[3].data(), a_rhs.data(), result.data());
+    return result;
+  }
+
+  Scalar t[4] = {a_rhs.x(), a_rhs.y(), a_rhs.z(), a_rhs.w()};
+  Scalar r[4];
   for (size_t row = 0; row < a_lhs.size(); ++row)
   {
-    double sum = 0.0;
+    Scalar sum = 0.0;
     for (size_t col = 0; col < a_lhs.size(); ++col)
     {
       sum += t[col] * a_lhs[row][col];
@@ -141,6 +178,9 @@ Matrix Matrix::identity_matrix(size_t a_size)
 //------------------------------------------------------------------------------
 Matrix Matrix::transpose() const
 {
+  if (size_ == 4)
+    return to_matrix4().transpose();
+
   Matrix a;
   for (size_t row = 0; row < size_; ++row)
   {
@@ -153,9 +193,12 @@ Matrix Matrix::transpose() const
 }
 
 //------------------------------------------------------------------------------
-double Matrix::determinant() const
+Scalar Matrix::determinant() const
 {
-  double det = 0;
+  if (size_ == 4)
+    return to_matrix4().determinant();
+
+  Scalar det = 0;
 
   if (size_ == 2)
   {
@@ -192,16 +235,16 @@ Matrix Matrix::sub_matrix(int a_row_removed, int a_col_removed) const
 }
 
 //------------------------------------------------------------------------------
-double Matrix::minor(int a_row_removed, int a_col_removed) const
+Scalar Matrix::minor(int a_row_removed, int a_col_removed) const
 {
-  double d = sub_matrix(a_row_removed, a_col_removed).determinant();
+  Scalar d = sub_matrix(a_row_removed, a_col_removed).determinant();
   return d;
 }
 
 //------------------------------------------------------------------------------
-double Matrix::cofactor(int a_row_removed, int a_col_removed) const
+Scalar Matrix::cofactor(int a_row_removed, int a_col_removed) const
 {
-  double d = minor(a_row_removed, a_col_removed);
+  Scalar d = minor(a_row_removed, a_col_removed);
   if ((static_cast<unsigned int>(a_row_removed + a_col_removed) & 1) == 0)
     return d;
   else
@@ -217,12 +260,16 @@ bool Matrix::is_invertible() const
 //------------------------------------------------------------------------------
 Matrix Matrix::inverse() const
 {
+  stats::count(&RenderStats::matrix_inverses);
+  if (size_ == 4)
+    return to_matrix4().inverse();
+
   Matrix a;
   for (int row = 0; row < size_; ++row)
   {
     for (int col = 0; col < size_; ++col)
     {
-      double c = cofactor(row, col);
+      Scalar c = cofactor(row, col);
       // note that "col, row" here, instead of "row, col",
       // accomplishes the transpose operation!
       a[col][row] = c / determinant();
@@ -262,12 +309,15 @@ bool Matrix::nearly_equal(const Matrix& a_rhs) const
 //------------------------------------------------------------------------------
 Matrix operator*(const Matrix& a_lhs, const Matrix& a_rhs)
 {
+  if (a_lhs.size() == 4 && a_rhs.size() == 4)
+    return a_lhs.to_matrix4() * a_rhs.to_matrix4();
+
   Matrix c;
   for (size_t row = 0; row < a_lhs.size(); ++row)
   {
     for (size_t col = 0; col < a_lhs.size(); ++col)
     {
-      double sum = 0.0;
+      Scalar sum = 0.0;
       for (size_t k = 0; k < a_lhs.size(); ++k)
       {
         sum += a_lhs[row][k] * a_rhs[k][col];
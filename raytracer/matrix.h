@@ -1,7 +1,9 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 
+#include <raytracer/square_matrix.h>
 #include <raytracer/tuple.h>
 
 #undef minor
@@ -17,17 +19,24 @@ public:
 
   /// Construct a MatrixRow with an initializer list.
   /// \param a_list The initializer list.
-  MatrixRow(const std::initializer_list<double>& a_list);
+  MatrixRow(const std::initializer_list<Scalar>& a_list);
 
   /// Array operator to access row elements.
   /// \param a_col_index The element index to access.
   /// \return The element value.
-  double& operator[](size_t a_col_index);
+  Scalar& operator[](size_t a_col_index);
 
   /// Array operator to access row elements from a const MatrixRow.
   /// \param a_col_index The element index to access.
   /// \return The element value.
-  double operator[](size_t a_col_index) const;
+  Scalar operator[](size_t a_col_index) const;
+
+  /// Get the row elements as an array.
+  /// \return Pointer to the 4 row elements.
+  const Scalar* data() const
+  {
+    return m_.data();
+  }
 
   /// Equals operator to determine if two MatrixRows are equal.
   /// \param a_rhs The row to compare against.
@@ -40,10 +49,12 @@ public:
   bool operator!=(const MatrixRow& a_rhs) const;
 
 protected:
-  std::array<double, 4> m_; ///< Values for the row.
+  std::array<Scalar, 4> m_; ///< Values for the row.
 };
 
 /// A matrix that can be from size 1x1 to 4x4.
+/// 4x4 products, determinants, transposes and inverses are computed with the
+/// fixed size Matrix4.
 class Matrix
 {
 public:
@@ -55,6 +66,14 @@ public:
   /// \param a_list The initializer list.
   Matrix(const std::initializer_list<MatrixRow>& a_list);
 
+  /// Construct a 4x4 Matrix from a fixed size matrix.
+  /// \param a_matrix The fixed size matrix.
+  Matrix(const Matrix4& a_matrix);
+
+  /// Get a copy of a 4x4 matrix as a fixed size matrix.
+  /// \return The fixed size matrix.
+  Matrix4 to_matrix4() const;
+
   /// Get the number of rows and columns of the matrix.
   /// \result The number of rows and column of the matrix.
   size_t size() const
@@ -93,7 +112,7 @@ public:
 
   /// Get the determinant of the matrix.
   /// \return The determinant of the matrix.
-  double determinant() const;
+  Scalar determinant() const;
 
   /// Return a sub matrix with given row and column removed.
   /// \param a_row_removed The row to be removed.
@@ -105,13 +124,13 @@ public:
   /// \param a_row_removed The row to be removed.
   /// \param a_col_removed The column to be removed.
   /// \return The minor of the matrix.
-  double minor(int a_row_removed, int a_col_removed) const;
+  Scalar minor(int a_row_removed, int a_col_removed) const;
 
   /// Return the cofactor with given row and column removed.
   /// \param a_row_removed The row to be removed.
   /// \param a_col_removed The column to be removed.
   /// \return The cofactor of the matrix.
-  double cofactor(int a_row_removed, int a_col_removed) const;
+  Scalar cofactor(int a_row_removed, int a_col_removed) const;
 
   /// Determine if the matrix is invertible.
   /// \return True if the matrix is invertible.
@@ -0,0 +1,46 @@
+#include <raytracer/plane.h>
+
+#include <cmath>
+
+#include <raytracer/intersection.h>
+#include <raytracer/ray.h>
+
+
+//------------------------------------------------------------------------------
+std::unique_ptr<Plane> Plane::new_ptr()
+{
+  return std::make_unique<Plane>();
+}
+
+
+//------------------------------------------------------------------------------
+bool Plane::intersect_distance(const Ray& a_ray, Scalar& a_t) const
+{
+  // only the height of the ray in plane coordinates is needed
+  const MatrixRow& row = inverse_transform()[1];
+  Tuple y_row(row[0], row[1], row[2], row[3]);
+  Scalar origin_y = dot(y_row, a_ray.origin());
+  Scalar direction_y = dot(y_row, a_ray.direction());
+  if (std::abs(direction_y) < EPSILON)
+    return false;
+  a_t = -origin_y / direction_y;
+  return true;
+}
+
+
+//------------------------------------------------------------------------------
+void Plane::local_intersect(const Ray& a_local_ray,
+    std::vector<Intersection>& a_intersections) const
+{
+  if (std::abs(a_local_ray.direction().y()) < EPSILON)
+    return;
+  Scalar t = -a_local_ray.origin().y() / a_local_ray.direction().y();
+  a_intersections.emplace_back(t, *this);
+}
+
+
+//------------------------------------------------------------------------------
+Tuple Plane::local_normal_at(const Tuple&) const
+{
+  return vector(0, 1, 0);
+}
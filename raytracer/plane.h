@@ -0,0 +1,41 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <raytracer/shape.h>
+#include <raytracer/tuple.h>
+
+
+class Intersection;
+
+class Ray;
+
+/// An infinite plane through the origin of its object space, spanning the
+/// x and z axes.
+class Plane : public Shape
+{
+public:
+  /// Construct a Plane shared pointer.
+  /// \return The Plane shared pointer.
+  static std::unique_ptr<Plane> new_ptr();
+
+  /// Get the distance (if any) along the ray where it meets this plane.
+  /// Rays parallel to the plane never meet it.
+  /// \param a_ray The ray to intersect with the plane.
+  /// \param a_t Receives the distance.
+  /// \return True if the ray meets the plane.
+  bool intersect_distance(const Ray& a_ray, Scalar& a_t) const;
+
+  /// Append the intersection (if any) of a ray in plane coordinates.
+  /// \param a_local_ray The ray in the object space of the plane.
+  /// \param a_intersections The list to append the intersection to.
+  void local_intersect(const Ray& a_local_ray,
+      std::vector<Intersection>& a_intersections) const override;
+
+  /// Get the normal of the plane in plane coordinates, which is the same
+  /// everywhere.
+  /// \param a_local_point The object space point on the plane.
+  /// \return The object space normal.
+  Tuple local_normal_at(const Tuple& a_local_point) const override;
+};
@@ -0,0 +1,105 @@
+#include <raytracer/ppm_writer.h>
+
+#include <algorithm>
+
+#include <raytracer/canvas.h>
+#include <raytracer/trace.h>
+
+
+namespace
+{
+//------------------------------------------------------------------------------
+int scale_fraction(double a_val, int a_upper_value)
+{
+  int result = static_cast<int>(a_val * (a_upper_value + 1));
+  if (result > a_upper_value)
+    result = a_upper_value;
+  else if (result < 0)
+    result = 0;
+  return result;
+}
+} // namespace
+
+//------------------------------------------------------------------------------
+PpmWriter::PpmWriter(std::ostream& a_output, int a_width, int a_height,
+    PpmFormat a_format)
+    : output_(a_output)
+      , width_(a_width)
+      , height_(a_height)
+      , format_(a_format)
+      , rows_written_(0)
+{
+  a_output << (a_format == PpmFormat::P3 ? "P3\n" : "P6\n");
+  a_output << width_ << " " << height_ << "\n";
+  a_output << "255\n";
+  // a P3 value is at most three digits and a separator
+  buffer_.reserve(static_cast<size_t>(a_width) * 3 * 4 + 1);
+}
+
+//------------------------------------------------------------------------------
+void PpmWriter::write_row(const Color* a_pixels)
+{
+  buffer_.clear();
+  if (format_ == PpmFormat::P6)
+  {
+    for (int h = 0; h < width_; ++h)
+    {
+      buffer_ += static_cast<char>(scale_fraction(a_pixels[h].red(), 255));
+      buffer_ += static_cast<char>(scale_fraction(a_pixels[h].green(), 255));
+      buffer_ += static_cast<char>(scale_fraction(a_pixels[h].blue(), 255));
+    }
+  }
+  else
+  {
+    int line_length = 0;
+    for (int h = 0; h < width_; ++h)
+    {
+      append_value(scale_fraction(a_pixels[h].red(), 255), line_length);
+      append_value(scale_fraction(a_pixels[h].green(), 255), line_length);
+      append_value(scale_fraction(a_pixels[h].blue(), 255), line_length);
+    }
+    buffer_ += '\n';
+  }
+  output_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+  ++rows_written_;
+}
+
+//------------------------------------------------------------------------------
+void PpmWriter::write_rows(const Canvas& a_canvas, int a_row_end)
+{
+  trace::Span span("ppm encode");
+  a_row_end = std::min(a_row_end, height_);
+  for (int v = rows_written_; v < a_row_end; ++v)
+  {
+    write_row(a_canvas.data() + static_cast<size_t>(v) * width_);
+  }
+}
+
+//------------------------------------------------------------------------------
+void PpmWriter::append_value(int a_value, int& a_line_length)
+{
+  // values are 0 to 255 so at most three digits
+  char digits[3];
+  int value_length = 0;
+  do
+  {
+    digits[value_length++] = static_cast<char>('0' + a_value % 10);
+    a_value /= 10;
+  } while (a_value > 0);
+
+  if (a_line_length + value_length + 1 > 70)
+  {
+    buffer_ += '\n';
+    a_line_length = 0;
+  }
+  if (a_line_length != 0)
+  {
+    buffer_ += ' ';
+    ++a_line_length;
+  }
+  while (value_length > 0)
+  {
+    buffer_ += digits[--value_length];
+    ++a_line_length;
+  }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+
+#include <raytracer/color.h>
+
+
+class Canvas;
+
+/// The encoding of PPM pixel data.
+enum class PpmFormat
+{
+  P3, ///< Plain text values wrapped at 70 characters.
+  P6  ///< One byte per color channel.
+};
+
+/// Writes a PPM image a row at a time.
+///
+/// The header is written on construction and rows are appended in order, so
+/// rows can be written as soon as they have been rendered.
+class PpmWriter
+{
+public:
+  /// Construct a writer and write the PPM header.
+  /// \param a_output The output stream to write the image to.
+  /// \param a_width The number of pixels in horizontal direction.
+  /// \param a_height The number of pixels in the vertical direction.
+  /// \param a_format The encoding of the pixel data.
+  PpmWriter(std::ostream& a_output, int a_width, int a_height,
+      PpmFormat a_format = PpmFormat::P3);
+
+  /// Get the number of rows written so far.
+  /// \return The number of rows written.
+  int rows_written() const
+  {
+    return rows_written_;
+  }
+
+  /// Write the next row of the image.
+  /// \param a_pixels The width pixels of the row.
+  void write_row(const Color* a_pixels);
+
+  /// Write rows of a canvas up to a given row.
+  /// Rows that have already been written are skipped.
+  /// \param a_canvas The canvas to write rows from.
+  /// \param a_row_end One past the last row to write.
+  void write_rows(const Canvas& a_canvas, int a_row_end);
+
+private:
+  void append_value(int a_value, int& a_line_length);
+
+  std::ostream& output_; ///< The stream being written to.
+  int width_;            ///< The number of pixels in horizontal direction.
+  int height_;           ///< The number of pixels in the vertical direction.
+  PpmFormat format_;     ///< The encoding of the pixel data.
+  int rows_written_;     ///< The number of rows written so far.
+  std::string buffer_;   ///< The encoded row being built.
+};
@@ -4,7 +4,7 @@
 
 
 //------------------------------------------------------------------------------
-Tuple Ray::position(double a_t) const
+Tuple Ray::position(Scalar a_t) const
 {
   return origin() + direction() * a_t;
 }
@@ -36,7 +36,7 @@ public:
   /// Get a point a distance t from the ray origin.
   /// \param a_t The distance from the ray origin.
   /// \return The point at distance t from the ray origin.
-  Tuple position(double a_t) const;
+  Tuple position(Scalar a_t) const;
 
   /// Transform the ray by the given transformation matrix.
   /// \param a_transform The transformation matrix.
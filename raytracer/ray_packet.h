@@ -0,0 +1,74 @@
+#pragma once
+
+#include <raytracer/ray.h>
+
+
+/// A group of rays stored as a structure of arrays, one lane per ray, so
+/// that the same operation can be applied to every ray at once.
+/// \tparam N The number of lanes (4, 8 or 16).
+template <int N>
+struct RayPacket
+{
+  static_assert(N == 4 || N == 8 || N == 16,
+                "A ray packet holds 4, 8 or 16 rays");
+
+  /// Store a ray in a lane.
+  /// \param a_lane The lane index.
+  /// \param a_ray The ray to store.
+  void set(int a_lane, const Ray& a_ray)
+  {
+    const Tuple& origin = a_ray.origin();
+    const Tuple& direction = a_ray.direction();
+    origin_x[a_lane] = origin.x();
+    origin_y[a_lane] = origin.y();
+    origin_z[a_lane] = origin.z();
+    origin_w[a_lane] = origin.w();
+    direction_x[a_lane] = direction.x();
+    direction_y[a_lane] = direction.y();
+    direction_z[a_lane] = direction.z();
+    direction_w[a_lane] = direction.w();
+  }
+
+  /// Get the ray stored in a lane.
+  /// \param a_lane The lane index.
+  /// \return The ray in the lane.
+  Ray ray(int a_lane) const
+  {
+    return {Tuple(origin_x[a_lane], origin_y[a_lane], origin_z[a_lane],
+                  origin_w[a_lane]),
+            Tuple(direction_x[a_lane], direction_y[a_lane],
+                  direction_z[a_lane], direction_w[a_lane])};
+  }
+
+  /// Copy the last used lane into the unused lanes so that operations over
+  /// all N lanes never read uninitialized values.
+  void pad()
+  {
+    for (int lane = count; lane < N; ++lane)
+      set(lane, ray(count - 1));
+  }
+
+  int count = 0;                     ///< Number of lanes holding rays.
+  alignas(32) Scalar origin_x[N];    ///< Origin X of each ray.
+  alignas(32) Scalar origin_y[N];    ///< Origin Y of each ray.
+  alignas(32) Scalar origin_z[N];    ///< Origin Z of each ray.
+  alignas(32) Scalar origin_w[N];    ///< Origin W of each ray.
+  alignas(32) Scalar direction_x[N]; ///< Direction X of each ray.
+  alignas(32) Scalar direction_y[N]; ///< Direction Y of each ray.
+  alignas(32) Scalar direction_z[N]; ///< Direction Z of each ray.
+  alignas(32) Scalar direction_w[N]; ///< Direction W of each ray.
+};
+
+/// Distances where each ray of a packet enters and leaves an object.
+/// \tparam N The number of lanes (4, 8 or 16).
+template <int N>
+struct RayPacketHits
+{
+  alignas(32) Scalar t_1[N]; ///< The nearer distance of each lane.
+  alignas(32) Scalar t_2[N]; ///< The farther distance of each lane.
+  bool hit[N];               ///< True for lanes whose ray hits the object.
+};
+
+typedef RayPacket<4> RayPacket4;   ///< Packet of 4 rays.
+typedef RayPacket<8> RayPacket8;   ///< Packet of 8 rays.
+typedef RayPacket<16> RayPacket16; ///< Packet of 16 rays.
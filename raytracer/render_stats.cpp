@@ -0,0 +1,50 @@
+#include <raytracer/render_stats.h>
+
+#include <ostream>
+
+
+#if defined(RAYTRACER_STATS)
+thread_local RenderStats stats::thread_stats;
+#endif
+
+//------------------------------------------------------------------------------
+void RenderStats::merge(const RenderStats& a_rhs)
+{
+  primary_rays += a_rhs.primary_rays;
+  shadow_rays += a_rhs.shadow_rays;
+  sphere_intersects += a_rhs.sphere_intersects;
+  sphere_hits += a_rhs.sphere_hits;
+  matrix_inverses += a_rhs.matrix_inverses;
+  setup_seconds += a_rhs.setup_seconds;
+  trace_seconds += a_rhs.trace_seconds;
+  shade_seconds += a_rhs.shade_seconds;
+  output_seconds += a_rhs.output_seconds;
+}
+
+//------------------------------------------------------------------------------
+void RenderStats::write_json(std::ostream& a_output) const
+{
+  a_output << "{\n  \"enabled\": " << (enabled ? "true" : "false") << ",";
+  a_output << "\n  \"primary_rays\": " << primary_rays << ",";
+  a_output << "\n  \"shadow_rays\": " << shadow_rays << ",";
+  a_output << "\n  \"sphere_intersects\": " << sphere_intersects << ",";
+  a_output << "\n  \"sphere_hits\": " << sphere_hits << ",";
+  a_output << "\n  \"sphere_misses\": " << sphere_misses() << ",";
+  a_output << "\n  \"matrix_inverses\": " << matrix_inverses << ",";
+  a_output << "\n  \"seconds\": {\"setup\": " << setup_seconds
+           << ", \"trace\": " << trace_seconds
+           << ", \"shade\": " << shade_seconds
+           << ", \"output\": " << output_seconds << "}\n}\n";
+}
+
+//------------------------------------------------------------------------------
+RenderStats stats::take()
+{
+#if defined(RAYTRACER_STATS)
+  RenderStats taken = thread_stats;
+  thread_stats = RenderStats();
+  return taken;
+#else
+  return RenderStats();
+#endif
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <chrono>
+#include <iosfwd>
+
+
+/// Counts and phase times of a render.
+///
+/// Statistics are only gathered when the library is built with the
+/// RAYTRACER_STATS CMake option. Otherwise the counters and timers below
+/// compile to nothing and every value stays zero.
+struct RenderStats
+{
+#if defined(RAYTRACER_STATS)
+  static constexpr bool enabled = true;  ///< Statistics are gathered.
+#else
+  static constexpr bool enabled = false; ///< Statistics are not gathered.
+#endif
+
+  long long primary_rays = 0;      ///< Rays cast from the camera.
+  long long shadow_rays = 0;       ///< Rays cast towards lights.
+  long long sphere_intersects = 0; ///< Rays tested against a sphere.
+  long long sphere_hits = 0;       ///< Sphere tests where the ray met it.
+  long long matrix_inverses = 0;   ///< Matrices inverted.
+  double setup_seconds = 0;        ///< Wall time before tracing starts.
+  double trace_seconds = 0;        ///< Thread time finding primary hits.
+  double shade_seconds = 0;        ///< Thread time shading primary hits.
+  double output_seconds = 0;       ///< Thread time handing out rows.
+
+  /// Get the number of sphere tests where the ray missed.
+  /// \return The number of misses.
+  long long sphere_misses() const
+  {
+    return sphere_intersects - sphere_hits;
+  }
+
+  /// Add the counts and times of another set of statistics.
+  /// \param a_rhs The statistics to add.
+  void merge(const RenderStats& a_rhs);
+
+  /// Write the statistics as a JSON object.
+  /// \param a_output The stream to write to.
+  void write_json(std::ostream& a_output) const;
+};
+
+namespace stats
+{
+
+#if defined(RAYTRACER_STATS)
+
+/// The statistics gathered by the calling thread.
+extern thread_local RenderStats thread_stats;
+
+/// Add to a counter of the calling thread.
+/// \param a_counter The counter to add to.
+/// \param a_amount The amount to add.
+inline void count(long long RenderStats::*a_counter, long long a_amount = 1)
+{
+  thread_stats.*a_counter += a_amount;
+}
+
+/// Adds the time from construction to destruction to a phase time of the
+/// calling thread.
+class ScopedPhase
+{
+public:
+  /// Start timing a phase.
+  /// \param a_phase The phase time to add to.
+  explicit ScopedPhase(double RenderStats::*a_phase)
+      : phase_(a_phase)
+        , start_(std::chrono::steady_clock::now())
+  {
+  }
+
+  ~ScopedPhase()
+  {
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start_;
+    thread_stats.*phase_ += elapsed.count();
+  }
+
+  ScopedPhase(const ScopedPhase&) = delete;
+  ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+private:
+  double RenderStats::*phase_;                  ///< The phase timed.
+  std::chrono::steady_clock::time_point start_; ///< When timing began.
+};
+
+#else
+
+inline void count(long long RenderStats::*, long long = 1)
+{
+}
+
+class ScopedPhase
+{
+public:
+  explicit ScopedPhase(double RenderStats::*)
+  {
+  }
+};
+
+#endif
+
+/// Get the statistics gathered by the calling thread and start again from
+/// zero.
+/// \return The statistics gathered since the last call.
+RenderStats take();
+
+} // namespace stats
@@ -0,0 +1,46 @@
+#include <raytracer/row_reporter.h>
+
+#include <algorithm>
+#include <utility>
+
+
+//------------------------------------------------------------------------------
+RowReporter::RowReporter(int a_tiles_across, int a_band_height, int a_height,
+    ReportCallback a_report)
+    : tiles_across_(a_tiles_across)
+      , band_height_(a_band_height)
+      , height_(a_height)
+      , report_(std::move(a_report))
+      , band_tiles_done_((a_height + a_band_height - 1) / a_band_height, 0)
+      , bands_done_(0)
+      , rows_reported_(0)
+      , reporting_(false)
+{
+}
+
+//------------------------------------------------------------------------------
+void RowReporter::tile_done(int a_band)
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  ++band_tiles_done_[a_band];
+  int band_count = static_cast<int>(band_tiles_done_.size());
+  while (bands_done_ < band_count &&
+         band_tiles_done_[bands_done_] == tiles_across_)
+  {
+    ++bands_done_;
+  }
+  if (reporting_)
+    return;
+
+  reporting_ = true;
+  int rows_done = std::min(bands_done_ * band_height_, height_);
+  while (rows_done > rows_reported_)
+  {
+    lock.unlock();
+    report_(rows_done);
+    lock.lock();
+    rows_reported_ = rows_done;
+    rows_done = std::min(bands_done_ * band_height_, height_);
+  }
+  reporting_ = false;
+}
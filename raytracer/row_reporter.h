@@ -0,0 +1,43 @@
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <vector>
+
+
+/// Reports the rows of a tiled image as its tiles are finished.
+///
+/// Tiles are finished by several threads in any order. Rows are reported in
+/// order once every tile of their band is finished, one report at a time, by
+/// a thread that holds no lock, so the other threads go on finishing tiles
+/// meanwhile. That thread reports again if more rows are completed before it
+/// returns.
+class RowReporter
+{
+public:
+  /// Function called with the number of rows complete from the top.
+  using ReportCallback = std::function<void(int)>;
+
+  /// Construct a row reporter.
+  /// \param a_tiles_across The number of tiles in each band of rows.
+  /// \param a_band_height The number of rows in each band.
+  /// \param a_height The number of rows in the image.
+  /// \param a_report The function called as rows are completed.
+  RowReporter(int a_tiles_across, int a_band_height, int a_height,
+      ReportCallback a_report);
+
+  /// Record a finished tile, reporting any rows it completes.
+  /// \param a_band The index of the band holding the tile.
+  void tile_done(int a_band);
+
+private:
+  int tiles_across_;                 ///< Tiles in each band.
+  int band_height_;                  ///< Rows in each band.
+  int height_;                       ///< Rows in the image.
+  ReportCallback report_;            ///< Called as rows are completed.
+  std::mutex mutex_;                 ///< Guards the counts below.
+  std::vector<int> band_tiles_done_; ///< Finished tiles in each band.
+  int bands_done_;                   ///< Bands finished from the top.
+  int rows_reported_;                ///< Rows reported so far.
+  bool reporting_;                   ///< Whether a thread is reporting.
+};
@@ -0,0 +1,13 @@
+#pragma once
+
+// The floating point type of coordinates, colors and distances.
+//
+// The precision is chosen at build time with the RAYTRACER_PRECISION CMake
+// option, which defines RAYTRACER_FLOAT for single precision. Double
+// precision is used otherwise.
+
+#if defined(RAYTRACER_FLOAT)
+typedef float Scalar;
+#else
+typedef double Scalar;
+#endif
@@ -0,0 +1,551 @@
+#include <raytracer/scene_cache.h>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <raytracer/bounds.h>
+#include <raytracer/bvh.h>
+#include <raytracer/light.h>
+#include <raytracer/material.h>
+#include <raytracer/plane.h>
+#include <raytracer/sphere.h>
+#include <raytracer/sphere_store.h>
+#include <raytracer/trace.h>
+
+
+namespace
+{
+
+static_assert(std::is_trivially_copyable<Bounds>::value,
+              "Bounds are copied straight from a scene cache");
+static_assert(std::is_trivially_copyable<BvhNode>::value,
+              "BvhNodes are copied straight from a scene cache");
+static_assert(sizeof(int) == sizeof(std::int32_t),
+              "Object indices are stored as 32 bit integers");
+
+const char cache_magic[8] = {'R', 'T', 'S', 'C', 'E', 'N', 'E', '\0'};
+const std::uint32_t cache_version = 2;
+const std::uint32_t cache_byte_order = 0x01020304;
+const size_t section_alignment = 64;
+
+/// The start of a scene cache.
+struct CacheHeader
+{
+  char magic[8];                   ///< Identifies a scene cache.
+  std::uint32_t version;           ///< Version of the layout.
+  std::uint32_t byte_order;        ///< cache_byte_order as written.
+  std::uint32_t scalar_size;       ///< Size of a Scalar as written.
+  std::uint32_t bounds_size;       ///< Size of a Bounds as written.
+  std::uint32_t node_size;         ///< Size of a BvhNode as written.
+  std::int32_t h_size;             ///< Camera width in pixels.
+  std::int32_t v_size;             ///< Camera height in pixels.
+  std::int32_t light_count;        ///< Number of lights.
+  std::int32_t material_count;     ///< Number of distinct materials.
+  std::int32_t object_count;       ///< Number of spheres.
+  std::int32_t node_count;         ///< Number of hierarchy nodes.
+  std::int32_t leaf_object_count;  ///< Number of object indices in leaves.
+  std::int32_t plane_count;        ///< Number of planes.
+};
+
+/// Where each section of a scene cache starts. Each section starts on a
+/// multiple of section_alignment bytes so it can be read in place.
+struct CacheLayout
+{
+  /// Work out the layout of a cache from its header.
+  /// \param a_header The header of the cache.
+  explicit CacheLayout(const CacheHeader& a_header)
+  {
+    auto light_count = static_cast<size_t>(a_header.light_count);
+    auto material_count = static_cast<size_t>(a_header.material_count);
+    auto object_count = static_cast<size_t>(a_header.object_count);
+    auto node_count = static_cast<size_t>(a_header.node_count);
+    auto leaf_object_count = static_cast<size_t>(a_header.leaf_object_count);
+    auto plane_count = static_cast<size_t>(a_header.plane_count);
+    size_t offset = 0;
+    auto section = [&](size_t a_bytes)
+    {
+      size_t start = (offset + section_alignment - 1) / section_alignment *
+                     section_alignment;
+      offset = start + a_bytes;
+      return start;
+    };
+    section(sizeof(CacheHeader));
+    camera = section(17 * sizeof(Scalar));
+    lights = section(light_count * 6 * sizeof(Scalar));
+    materials = section(material_count * 7 * sizeof(Scalar));
+    object_materials = section(object_count * sizeof(std::int32_t));
+    transforms = section(object_count * 16 * sizeof(Scalar));
+    inverse_transforms = section(object_count * 16 * sizeof(Scalar));
+    bounds = section(object_count * sizeof(Bounds));
+    nodes = section(node_count * sizeof(BvhNode));
+    leaf_objects = section(leaf_object_count * sizeof(std::int32_t));
+    plane_materials = section(plane_count * sizeof(std::int32_t));
+    plane_transforms = section(plane_count * 16 * sizeof(Scalar));
+    plane_inverses = section(plane_count * 16 * sizeof(Scalar));
+    size = offset;
+  }
+
+  size_t camera;             ///< Field of view then the 16 transform values.
+  size_t lights;             ///< Position then intensity of each light.
+  size_t materials;          ///< Color, ambient, diffuse, specular, shininess.
+  size_t object_materials;   ///< Material index of each sphere.
+  size_t transforms;         ///< 16 transform values per sphere.
+  size_t inverse_transforms; ///< 16 inverse transform values per sphere.
+  size_t bounds;             ///< World bounds per sphere.
+  size_t nodes;              ///< Hierarchy nodes in depth first order.
+  size_t leaf_objects;       ///< Object indices referenced by the leaves.
+  size_t plane_materials;    ///< Material index of each plane.
+  size_t plane_transforms;   ///< 16 transform values per plane.
+  size_t plane_inverses;     ///< 16 inverse transform values per plane.
+  size_t size;               ///< Size of the whole cache.
+};
+
+/// A file mapped read only into memory, unmapped when destroyed.
+/// Uses file mappings on Windows and mmap elsewhere.
+class MappedFile
+{
+public:
+  /// Map a file.
+  /// \param a_path The path of the file.
+  explicit MappedFile(const std::string& a_path)
+  {
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(a_path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+      return;
+    LARGE_INTEGER file_size;
+    if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0)
+    {
+      HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0,
+                                          nullptr);
+      if (mapping)
+      {
+        void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (data)
+        {
+          data_ = static_cast<const char*>(data);
+          size_ = static_cast<size_t>(file_size.QuadPart);
+        }
+        // the view keeps the mapping open
+        CloseHandle(mapping);
+      }
+    }
+    CloseHandle(file);
+#else
+    int file = open(a_path.c_str(), O_RDONLY);
+    if (file < 0)
+      return;
+    struct stat status;
+    if (fstat(file, &status) == 0 && status.st_size > 0)
+    {
+      void* data = mmap(nullptr, static_cast<size_t>(status.st_size),
+                        PROT_READ, MAP_PRIVATE, file, 0);
+      if (data != MAP_FAILED)
+      {
+        data_ = static_cast<const char*>(data);
+        size_ = static_cast<size_t>(status.st_size);
+      }
+    }
+    close(file);
+#endif
+  }
+
+  ~MappedFile()
+  {
+    if (!data_)
+      return;
+#if defined(_WIN32)
+    UnmapViewOfFile(data_);
+#else
+    munmap(const_cast<char*>(data_), size_);
+#endif
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  /// Get the contents of the file.
+  /// \return The first byte, or nullptr if the file could not be mapped.
+  const char* data() const
+  {
+    return data_;
+  }
+
+  /// Get the size of the file.
+  /// \return The number of bytes mapped.
+  size_t size() const
+  {
+    return size_;
+  }
+
+private:
+  const char* data_ = nullptr; ///< The mapped contents.
+  size_t size_ = 0;            ///< The number of bytes mapped.
+};
+
+//------------------------------------------------------------------------------
+/// Write values at an offset of a file, padding up to the offset with zeros.
+void write_section(std::ofstream& a_file, size_t a_offset,
+    const void* a_values, size_t a_bytes)
+{
+  static const char zeros[section_alignment] = {};
+  size_t position = static_cast<size_t>(a_file.tellp());
+  a_file.write(zeros, static_cast<std::streamsize>(a_offset - position));
+  a_file.write(static_cast<const char*>(a_values),
+               static_cast<std::streamsize>(a_bytes));
+}
+
+//------------------------------------------------------------------------------
+/// Append the 16 values of a 4x4 matrix, row by row.
+void append_matrix(const Matrix& a_matrix, std::vector<Scalar>& a_values)
+{
+  for (int row = 0; row < 4; ++row)
+  {
+    const Scalar* values = a_matrix[row].data();
+    a_values.insert(a_values.end(), values, values + 4);
+  }
+}
+
+//------------------------------------------------------------------------------
+/// Make a 4x4 matrix from its 16 values, row by row.
+Matrix matrix_from(const Scalar* a_values)
+{
+  Matrix matrix;
+  for (int row = 0; row < 4; ++row)
+    for (int col = 0; col < 4; ++col)
+      matrix[row][col] = a_values[row * 4 + col];
+  return matrix;
+}
+
+//------------------------------------------------------------------------------
+/// Determine if the indices of a cache stay within its arrays and its
+/// hierarchy is shallow enough to traverse, so a damaged cache cannot send
+/// a render outside them.
+bool indices_valid(const CacheHeader& a_header, const std::int32_t* a_materials,
+    const BvhNode* a_nodes, const std::int32_t* a_leaf_objects,
+    const std::int32_t* a_plane_materials)
+{
+  for (int i = 0; i < a_header.object_count; ++i)
+  {
+    if (a_materials[i] < 0 || a_materials[i] >= a_header.material_count)
+      return false;
+  }
+  for (int i = 0; i < a_header.plane_count; ++i)
+  {
+    if (a_plane_materials[i] < 0 ||
+        a_plane_materials[i] >= a_header.material_count)
+    {
+      return false;
+    }
+  }
+  // children follow their parents, so one pass finds the depth of each node
+  std::vector<int> depths(static_cast<size_t>(a_header.node_count), 0);
+  for (int i = 0; i < a_header.node_count; ++i)
+  {
+    const BvhNode& node = a_nodes[i];
+    if (depths[i] >= Bvh::STACK_SIZE)
+      return false;
+    bool valid;
+    if (node.count > 0)
+    {
+      valid = node.first >= 0 &&
+              node.first <= a_header.leaf_object_count - node.count;
+    }
+    else
+    {
+      // the first child follows a branch, the second comes after it
+      valid = node.count == 0 && node.first > i + 1 &&
+              node.first < a_header.node_count && node.axis >= 0 &&
+              node.axis < 3;
+    }
+    if (!valid)
+      return false;
+    if (node.count == 0)
+    {
+      depths[i + 1] = std::max(depths[i + 1], depths[i] + 1);
+      depths[node.first] = std::max(depths[node.first], depths[i] + 1);
+    }
+  }
+  for (int i = 0; i < a_header.leaf_object_count; ++i)
+  {
+    if (a_leaf_objects[i] < 0 || a_leaf_objects[i] >= a_header.object_count)
+      return false;
+  }
+  return true;
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------
+bool save_scene_cache(const std::string& a_path, const Scene& a_scene,
+    std::string& a_error)
+{
+  const World& world = a_scene.world;
+  const Bvh& bvh = world.bvh();
+
+  // objects usually share a few materials, so store each one once
+  std::vector<Scalar> materials;
+  std::map<std::array<Scalar, 7>, std::int32_t> material_indices;
+  auto material_index = [&](const Material& a_material)
+  {
+    std::array<Scalar, 7> values = {{
+        a_material.color().red(), a_material.color().green(),
+        a_material.color().blue(), a_material.ambient(),
+        a_material.diffuse(), a_material.specular(),
+        a_material.shininess()}};
+    auto inserted = material_indices.emplace(
+        values, static_cast<std::int32_t>(material_indices.size()));
+    if (inserted.second)
+      materials.insert(materials.end(), values.begin(), values.end());
+    return inserted.first->second;
+  };
+
+  std::vector<std::int32_t> object_materials;
+  std::vector<Scalar> transforms;
+  std::vector<Scalar> inverse_transforms;
+  std::vector<Bounds> bounds;
+  object_materials.reserve(static_cast<size_t>(world.object_count()));
+  bounds.reserve(static_cast<size_t>(world.object_count()));
+  for (int i = 0; i < world.object_count(); ++i)
+  {
+    const Sphere& sphere = world.object(i);
+    object_materials.push_back(material_index(sphere.material()));
+    append_matrix(sphere.transform(), transforms);
+    append_matrix(sphere.inverse_transform(), inverse_transforms);
+    bounds.push_back(sphere.bounds());
+  }
+
+  std::vector<std::int32_t> plane_materials;
+  std::vector<Scalar> plane_transforms;
+  std::vector<Scalar> plane_inverses;
+  for (int i = 0; i < world.plane_count(); ++i)
+  {
+    const Plane& plane = world.plane(i);
+    plane_materials.push_back(material_index(plane.material()));
+    append_matrix(plane.transform(), plane_transforms);
+    append_matrix(plane.inverse_transform(), plane_inverses);
+  }
+
+  std::vector<Scalar> camera = {a_scene.camera.field_of_view()};
+  append_matrix(a_scene.camera.transform(), camera);
+
+  std::vector<Scalar> lights;
+  for (int i = 0; i < world.light_count(); ++i)
+  {
+    const Tuple& position = world.light(i).position();
+    const Color& intensity = world.light(i).intensity();
+    Scalar values[] = {position.x(), position.y(), position.z(),
+                       intensity.red(), intensity.green(), intensity.blue()};
+    lights.insert(lights.end(), values, values + 6);
+  }
+
+  CacheHeader header;
+  std::memcpy(header.magic, cache_magic, sizeof(cache_magic));
+  header.version = cache_version;
+  header.byte_order = cache_byte_order;
+  header.scalar_size = sizeof(Scalar);
+  header.bounds_size = sizeof(Bounds);
+  header.node_size = sizeof(BvhNode);
+  header.h_size = a_scene.camera.h_size();
+  header.v_size = a_scene.camera.v_size();
+  header.light_count = world.light_count();
+  header.material_count = static_cast<std::int32_t>(material_indices.size());
+  header.object_count = world.object_count();
+  header.node_count = static_cast<std::int32_t>(bvh.nodes().size());
+  header.leaf_object_count = static_cast<std::int32_t>(bvh.objects().size());
+  header.plane_count = world.plane_count();
+  CacheLayout layout(header);
+
+  std::ofstream file(a_path, std::ios::binary);
+  if (!file)
+  {
+    a_error = "cannot open " + a_path;
+    return false;
+  }
+  write_section(file, 0, &header, sizeof(header));
+  write_section(file, layout.camera, camera.data(),
+                camera.size() * sizeof(Scalar));
+  write_section(file, layout.lights, lights.data(),
+                lights.size() * sizeof(Scalar));
+  write_section(file, layout.materials, materials.data(),
+                materials.size() * sizeof(Scalar));
+  write_section(file, layout.object_materials, object_materials.data(),
+                object_materials.size() * sizeof(std::int32_t));
+  write_section(file, layout.transforms, transforms.data(),
+                transforms.size() * sizeof(Scalar));
+  write_section(file, layout.inverse_transforms, inverse_transforms.data(),
+                inverse_transforms.size() * sizeof(Scalar));
+  write_section(file, layout.bounds, bounds.data(),
+                bounds.size() * sizeof(Bounds));
+  write_section(file, layout.nodes, bvh.nodes().data(),
+                bvh.nodes().size() * sizeof(BvhNode));
+  write_section(file, layout.leaf_objects, bvh.objects().data(),
+                bvh.objects().size() * sizeof(std::int32_t));
+  write_section(file, layout.plane_materials, plane_materials.data(),
+                plane_materials.size() * sizeof(std::int32_t));
+  write_section(file, layout.plane_transforms, plane_transforms.data(),
+                plane_transforms.size() * sizeof(Scalar));
+  write_section(file, layout.plane_inverses,
+                plane_inverses.data(),
+                plane_inverses.size() * sizeof(Scalar));
+  write_section(file, layout.size, nullptr, 0);
+  if (!file)
+  {
+    a_error = "cannot write " + a_path;
+    return false;
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool load_scene_cache(const std::string& a_path, Scene& a_scene,
+    std::string& a_error)
+{
+  trace::Span span("load scene cache");
+  auto start = std::chrono::steady_clock::now();
+  MappedFile file(a_path);
+  if (!file.data())
+  {
+    a_error = "cannot open " + a_path;
+    return false;
+  }
+
+  CacheHeader header;
+  if (file.size() < sizeof(header))
+  {
+    a_error = a_path + ": not a scene cache";
+    return false;
+  }
+  std::memcpy(&header, file.data(), sizeof(header));
+  if (std::memcmp(header.magic, cache_magic, sizeof(cache_magic)) != 0 ||
+      header.version != cache_version)
+  {
+    a_error = a_path + ": not a scene cache";
+    return false;
+  }
+  if (header.byte_order != cache_byte_order ||
+      header.scalar_size != sizeof(Scalar) ||
+      header.bounds_size != sizeof(Bounds) ||
+      header.node_size != sizeof(BvhNode))
+  {
+    a_error = a_path + ": scene cache written by a different build";
+    return false;
+  }
+  if (header.h_size < 1 || header.v_size < 1 ||
+      header.h_size > MAX_CAMERA_SIZE || header.v_size > MAX_CAMERA_SIZE ||
+      header.light_count < 0 || header.material_count < 0 ||
+      header.object_count < 0 || header.node_count < 0 ||
+      header.leaf_object_count < 0 || header.plane_count < 0 ||
+      CacheLayout(header).size != file.size())
+  {
+    a_error = a_path + ": damaged scene cache";
+    return false;
+  }
+
+  CacheLayout layout(header);
+  const char* data = file.data();
+  auto camera = reinterpret_cast<const Scalar*>(data + layout.camera);
+  auto lights = reinterpret_cast<const Scalar*>(data + layout.lights);
+  auto materials = reinterpret_cast<const Scalar*>(data + layout.materials);
+  auto object_materials =
+      reinterpret_cast<const std::int32_t*>(data + layout.object_materials);
+  auto transforms = reinterpret_cast<const Scalar*>(data + layout.transforms);
+  auto inverse_transforms =
+      reinterpret_cast<const Scalar*>(data + layout.inverse_transforms);
+  auto bounds = reinterpret_cast<const Bounds*>(data + layout.bounds);
+  auto nodes = reinterpret_cast<const BvhNode*>(data + layout.nodes);
+  auto leaf_objects =
+      reinterpret_cast<const std::int32_t*>(data + layout.leaf_objects);
+  auto plane_materials =
+      reinterpret_cast<const std::int32_t*>(data + layout.plane_materials);
+  auto plane_transforms =
+      reinterpret_cast<const Scalar*>(data + layout.plane_transforms);
+  auto plane_inverses =
+      reinterpret_cast<const Scalar*>(data + layout.plane_inverses);
+  if (!indices_valid(header, object_materials, nodes, leaf_objects,
+                     plane_materials))
+  {
+    a_error = a_path + ": damaged scene cache";
+    return false;
+  }
+
+  Scene scene;
+  scene.camera = Camera(header.h_size, header.v_size, camera[0]);
+  scene.camera.set_transform(matrix_from(camera + 1));
+  for (int i = 0; i < header.light_count; ++i)
+  {
+    const Scalar* light = lights + i * 6;
+    scene.world.add_light(Light(point(light[0], light[1], light[2]),
+                                Color(light[3], light[4], light[5])));
+  }
+
+  std::vector<Material> shape_materials;
+  shape_materials.reserve(static_cast<size_t>(header.material_count));
+  for (int i = 0; i < header.material_count; ++i)
+  {
+    const Scalar* material = materials + i * 7;
+    shape_materials.emplace_back(
+        Color(material[0], material[1], material[2]), material[3],
+        material[4], material[5], material[6]);
+  }
+
+  std::vector<std::unique_ptr<Sphere>> spheres;
+  spheres.reserve(static_cast<size_t>(header.object_count));
+  for (int i = 0; i < header.object_count; ++i)
+  {
+    auto sphere = Sphere::new_ptr();
+    sphere->set_transform(matrix_from(transforms + i * 16),
+                          matrix_from(inverse_transforms + i * 16));
+    sphere->set_material(shape_materials[object_materials[i]]);
+    spheres.push_back(std::move(sphere));
+  }
+
+  for (int i = 0; i < header.plane_count; ++i)
+  {
+    auto plane = Plane::new_ptr();
+    plane->set_transform(matrix_from(plane_transforms + i * 16),
+                         matrix_from(plane_inverses + i * 16));
+    plane->set_material(shape_materials[plane_materials[i]]);
+    scene.world.add_object(std::move(plane));
+  }
+
+  SphereStore store;
+  store.assign(inverse_transforms, bounds, header.object_count);
+  Bvh bvh;
+  bvh.assign(nodes, header.node_count, leaf_objects,
+             header.leaf_object_count);
+  scene.world.set_objects(std::move(spheres), std::move(store),
+                          std::move(bvh));
+
+  std::chrono::duration<double> load_time =
+      std::chrono::steady_clock::now() - start;
+  scene.load_seconds = load_time.count();
+  a_scene = std::move(scene);
+  return true;
+}
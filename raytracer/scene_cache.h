@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string>
+
+#include <raytracer/scene_file.h>
+
+
+/// A scene cache is a binary copy of a loaded scene that can be mapped into
+/// memory and used without parsing.
+///
+/// It holds the camera, the lights, a table of the distinct materials and,
+/// for each sphere, its material index, transform, inverse transform and
+/// world bounds, followed by the nodes of the bounding volume hierarchy and,
+/// for each plane, its material index, transform and inverse transform.
+/// Loading copies these arrays straight into the world, so no matrix is
+/// inverted and no hierarchy is built. Values are stored in the layout of
+/// the build that wrote the cache, so a cache is only loaded by a build with
+/// the same Scalar type and byte order.
+
+/// Save a scene as a scene cache.
+/// \param a_path The path of the scene cache to write.
+/// \param a_scene The scene to save.
+/// \param a_error Receives a message describing the first error.
+/// \return True if the scene was saved.
+bool save_scene_cache(const std::string& a_path, const Scene& a_scene,
+    std::string& a_error);
+
+/// Load a scene from a scene cache by mapping it into memory.
+/// \param a_path The path of the scene cache.
+/// \param a_scene Receives the scene.
+/// \param a_error Receives a message describing the first error.
+/// \return True if the scene was loaded.
+bool load_scene_cache(const std::string& a_path, Scene& a_scene,
+    std::string& a_error);
@@ -0,0 +1,534 @@
+#include <raytracer/scene_file.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include <raytracer/light.h>
+#include <raytracer/material.h>
+#include <raytracer/plane.h>
+#include <raytracer/sphere.h>
+#include <raytracer/sphere_store.h>
+#include <raytracer/square_matrix.h>
+#include <raytracer/trace.h>
+#include <raytracer/transform.h>
+
+
+namespace
+{
+
+/// A material defined in a scene file.
+struct NamedMaterial
+{
+  std::string name;  ///< The name objects refer to it by.
+  Material material; ///< The material.
+};
+
+/// Reads the tokens of scene file text in place, without copying them.
+class SceneReader
+{
+public:
+  /// Construct a reader.
+  /// \param a_begin The first character of the text.
+  /// \param a_end One past the last character of the text.
+  SceneReader(const char* a_begin, const char* a_end)
+      : next_(a_begin)
+        , end_(a_end)
+        , line_(1)
+  {
+  }
+
+  /// Move to the first line holding a statement.
+  /// \return False if there are no more statements.
+  bool next_statement()
+  {
+    while (next_ < end_)
+    {
+      skip_spaces();
+      if (next_ == end_)
+        break;
+      if (*next_ != '\n')
+        return true;
+      ++next_;
+      ++line_;
+    }
+    return false;
+  }
+
+  /// Read the next token of the current line.
+  /// \param a_begin Receives the first character of the token.
+  /// \param a_end Receives one past the last character of the token.
+  /// \return False if the line has no more tokens.
+  bool token(const char*& a_begin, const char*& a_end)
+  {
+    skip_spaces();
+    if (next_ == end_ || *next_ == '\n')
+      return false;
+    a_begin = next_;
+    while (next_ < end_ && !is_space(*next_) && *next_ != '\n' &&
+           *next_ != '#')
+    {
+      ++next_;
+    }
+    a_end = next_;
+    return true;
+  }
+
+  /// Read a number from the next token of the current line.
+  /// \param a_value Receives the number.
+  /// \return False if the next token is missing or is not a number.
+  bool number(Scalar& a_value)
+  {
+    const char* begin;
+    const char* end;
+    double value;
+    if (!token(begin, end) || !parse_number(begin, end, value))
+      return false;
+    a_value = static_cast<Scalar>(value);
+    return true;
+  }
+
+  /// Read a point or vector from the next three tokens of the current line.
+  /// \param a_w The w value of the tuple (1 for a point, 0 for a vector).
+  /// \param a_tuple Receives the tuple.
+  /// \return False if a token is missing or is not a number.
+  bool tuple(Scalar a_w, Tuple& a_tuple)
+  {
+    Scalar x, y, z;
+    if (!number(x) || !number(y) || !number(z))
+      return false;
+    a_tuple = Tuple(x, y, z, a_w);
+    return true;
+  }
+
+  /// Determine if the current line has more tokens.
+  /// \return True if the line is finished.
+  bool at_line_end()
+  {
+    skip_spaces();
+    return next_ == end_ || *next_ == '\n';
+  }
+
+  /// Get the line being read.
+  /// \return The line number, starting at 1.
+  int line() const
+  {
+    return line_;
+  }
+
+private:
+  static bool is_space(char a_c)
+  {
+    return a_c == ' ' || a_c == '\t' || a_c == '\r';
+  }
+
+  /// Skip spaces and any comment, stopping at the end of the line.
+  void skip_spaces()
+  {
+    while (next_ < end_ && is_space(*next_))
+      ++next_;
+    if (next_ < end_ && *next_ == '#')
+    {
+      while (next_ < end_ && *next_ != '\n')
+        ++next_;
+    }
+  }
+
+  static bool parse_number(const char* a_begin, const char* a_end,
+      double& a_value);
+
+  const char* next_; ///< The next character to read.
+  const char* end_;  ///< One past the last character.
+  int line_;         ///< The line of the next character.
+};
+
+//------------------------------------------------------------------------------
+bool SceneReader::parse_number(const char* a_begin, const char* a_end,
+    double& a_value)
+{
+  // numbers of up to 15 significant digits without an exponent are exact
+  // as integers, and so are powers of ten up to 1e22, so a single division
+  // rounds them correctly; anything else goes through strtod
+  static const double powers_of_ten[] = {
+      1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12,
+      1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+  const char* c = a_begin;
+  bool negative = c < a_end && *c == '-';
+  if (c < a_end && (*c == '-' || *c == '+'))
+    ++c;
+  std::uint64_t mantissa = 0;
+  int significant_digits = 0;
+  int fraction_digits = 0;
+  bool any_digits = false;
+  bool in_fraction = false;
+  for (; c < a_end; ++c)
+  {
+    if (*c >= '0' && *c <= '9')
+    {
+      any_digits = true;
+      mantissa = mantissa * 10 + static_cast<std::uint64_t>(*c - '0');
+      if (mantissa > 0)
+        ++significant_digits;
+      if (in_fraction)
+        ++fraction_digits;
+      if (significant_digits > 15)
+        break;
+    }
+    else if (*c == '.' && !in_fraction)
+    {
+      in_fraction = true;
+    }
+    else
+    {
+      break;
+    }
+  }
+
+  if (c == a_end && any_digits && fraction_digits <= 22)
+  {
+    a_value = static_cast<double>(mantissa) / powers_of_ten[fraction_digits];
+    if (negative)
+      a_value = -a_value;
+    return true;
+  }
+
+  // the token is not terminated in the text so copy it for strtod
+  char buffer[64];
+  size_t length = static_cast<size_t>(a_end - a_begin);
+  if (length >= sizeof(buffer))
+    return false;
+  std::memcpy(buffer, a_begin, length);
+  buffer[length] = '\0';
+  char* parsed_end;
+  a_value = std::strtod(buffer, &parsed_end);
+  return length > 0 && parsed_end == buffer + length;
+}
+
+//------------------------------------------------------------------------------
+/// Compare a token with a word.
+bool token_is(const char* a_begin, const char* a_end, const char* a_word)
+{
+  size_t length = static_cast<size_t>(a_end - a_begin);
+  return std::strlen(a_word) == length &&
+         std::memcmp(a_begin, a_word, length) == 0;
+}
+
+//------------------------------------------------------------------------------
+/// Determine if a number is a whole camera size in pixels.
+bool is_camera_size(Scalar a_size)
+{
+  return std::isfinite(a_size) && std::floor(a_size) == a_size &&
+         a_size >= 1 && a_size <= MAX_CAMERA_SIZE;
+}
+
+//------------------------------------------------------------------------------
+/// Read a camera statement.
+bool read_camera(SceneReader& a_reader, Camera& a_camera)
+{
+  const char* begin;
+  const char* end;
+  Scalar width, height, field_of_view;
+  Tuple from, to, up;
+  if (!a_reader.number(width) || !a_reader.number(height) ||
+      !a_reader.number(field_of_view) || !is_camera_size(width) ||
+      !is_camera_size(height) ||
+      !a_reader.token(begin, end) || !token_is(begin, end, "from") ||
+      !a_reader.tuple(1, from) ||
+      !a_reader.token(begin, end) || !token_is(begin, end, "to") ||
+      !a_reader.tuple(1, to) ||
+      !a_reader.token(begin, end) || !token_is(begin, end, "up") ||
+      !a_reader.tuple(0, up))
+  {
+    return false;
+  }
+
+  a_camera = Camera(static_cast<int>(width), static_cast<int>(height),
+                    field_of_view);
+  a_camera.set_transform(view_transform(from, to, up));
+  return true;
+}
+
+//------------------------------------------------------------------------------
+/// Read a light statement.
+bool read_light(SceneReader& a_reader, World& a_world)
+{
+  Tuple position;
+  Scalar red, green, blue;
+  if (!a_reader.tuple(1, position) || !a_reader.number(red) ||
+      !a_reader.number(green) || !a_reader.number(blue))
+  {
+    return false;
+  }
+  a_world.add_light(Light(position, Color(red, green, blue)));
+  return true;
+}
+
+//------------------------------------------------------------------------------
+/// Read a material statement.
+bool read_material(SceneReader& a_reader,
+    std::vector<NamedMaterial>& a_materials)
+{
+  const char* begin;
+  const char* end;
+  if (!a_reader.token(begin, end) || token_is(begin, end, "-"))
+    return false;
+
+  NamedMaterial named;
+  named.name.assign(begin, end);
+  Material& material = named.material;
+  while (a_reader.token(begin, end))
+  {
+    Scalar value;
+    if (token_is(begin, end, "color"))
+    {
+      Scalar green, blue;
+      if (!a_reader.number(value) || !a_reader.number(green) ||
+          !a_reader.number(blue))
+      {
+        return false;
+      }
+      material.set_color(Color(value, green, blue));
+    }
+    else if (!a_reader.number(value))
+      return false;
+    else if (token_is(begin, end, "ambient"))
+      material.set_ambient(value);
+    else if (token_is(begin, end, "diffuse"))
+      material.set_diffuse(value);
+    else if (token_is(begin, end, "specular"))
+      material.set_specular(value);
+    else if (token_is(begin, end, "shininess"))
+      material.set_shininess(value);
+    else
+      return false;
+  }
+  a_materials.push_back(std::move(named));
+  return true;
+}
+
+//------------------------------------------------------------------------------
+/// Read a transform of a sphere or plane statement.
+/// The transform is a fixed size matrix so that composing several of them
+/// converts between matrix types only once per object.
+bool read_transform(SceneReader& a_reader, const char* a_begin,
+    const char* a_end, Matrix4& a_transform)
+{
+  Scalar v[6];
+  if (token_is(a_begin, a_end, "translate"))
+  {
+    if (!a_reader.number(v[0]) || !a_reader.number(v[1]) ||
+        !a_reader.number(v[2]))
+    {
+      return false;
+    }
+    a_transform = Matrix4::identity();
+    a_transform(0, 3) = v[0];
+    a_transform(1, 3) = v[1];
+    a_transform(2, 3) = v[2];
+  }
+  else if (token_is(a_begin, a_end, "scale"))
+  {
+    if (!a_reader.number(v[0]) || !a_reader.number(v[1]) ||
+        !a_reader.number(v[2]))
+    {
+      return false;
+    }
+    a_transform = Matrix4::identity();
+    a_transform(0, 0) = v[0];
+    a_transform(1, 1) = v[1];
+    a_transform(2, 2) = v[2];
+  }
+  else if (token_is(a_begin, a_end, "rotate_x") ||
+           token_is(a_begin, a_end, "rotate_y") ||
+           token_is(a_begin, a_end, "rotate_z"))
+  {
+    if (!a_reader.number(v[0]))
+      return false;
+    char axis = a_begin[7];
+    Matrix rotation = axis == 'x' ? rotation_x(v[0]) :
+                      axis == 'y' ? rotation_y(v[0]) : rotation_z(v[0]);
+    a_transform = rotation.to_matrix4();
+  }
+  else if (token_is(a_begin, a_end, "shear"))
+  {
+    for (Scalar& value : v)
+    {
+      if (!a_reader.number(value))
+        return false;
+    }
+    a_transform = shearing(v[0], v[1], v[2], v[3], v[4], v[5]).to_matrix4();
+  }
+  else
+  {
+    return false;
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+/// Read the material and transforms of a sphere or plane statement.
+bool read_shape(SceneReader& a_reader,
+    const std::vector<NamedMaterial>& a_materials, Shape& a_shape)
+{
+  const char* begin;
+  const char* end;
+  if (!a_reader.token(begin, end))
+    return false;
+
+  const Material* material = nullptr;
+  if (!token_is(begin, end, "-"))
+  {
+    // scenes have few materials so a linear search is fast enough
+    size_t length = static_cast<size_t>(end - begin);
+    for (const NamedMaterial& named : a_materials)
+    {
+      if (named.name.size() == length &&
+          std::memcmp(named.name.data(), begin, length) == 0)
+      {
+        material = &named.material;
+      }
+    }
+    if (!material)
+      return false;
+  }
+
+  if (a_reader.token(begin, end))
+  {
+    Matrix4 transform;
+    if (!read_transform(a_reader, begin, end, transform))
+      return false;
+    Matrix4 next;
+    while (a_reader.token(begin, end))
+    {
+      if (!read_transform(a_reader, begin, end, next))
+        return false;
+      transform = transform * next;
+    }
+    a_shape.set_transform(transform, transform.inverse());
+  }
+  if (material)
+    a_shape.set_material(*material);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+/// Read a sphere or plane statement and append the shape to a list.
+template <typename T>
+bool read_object(SceneReader& a_reader,
+    const std::vector<NamedMaterial>& a_materials,
+    std::vector<std::unique_ptr<T>>& a_objects)
+{
+  std::unique_ptr<T> object = T::new_ptr();
+  if (!read_shape(a_reader, a_materials, *object))
+    return false;
+  a_objects.push_back(std::move(object));
+  return true;
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------
+bool parse_scene(const char* a_text, size_t a_size, Scene& a_scene,
+    std::string& a_error)
+{
+  trace::Span span("parse scene");
+  auto start = std::chrono::steady_clock::now();
+  Scene scene;
+  std::vector<NamedMaterial> materials;
+  // the spheres and their intersection data are given to the world in bulk
+  // once they are all read, and there can be no more of them than lines
+  int line_count = static_cast<int>(std::count(a_text, a_text + a_size, '\n'));
+  std::vector<std::unique_ptr<Sphere>> spheres;
+  spheres.reserve(static_cast<size_t>(line_count) + 1);
+  SphereStore store;
+  store.reserve(line_count + 1);
+  std::vector<std::unique_ptr<Plane>> planes;
+  SceneReader reader(a_text, a_text + a_size);
+  while (reader.next_statement())
+  {
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    // next_statement() stops at a token, so this only skips a blank line
+    if (!reader.token(begin, end))
+      continue;
+    bool read = false;
+    if (token_is(begin, end, "sphere"))
+    {
+      // copied while the sphere is still in the cache
+      read = read_object(reader, materials, spheres);
+      if (read)
+        store.add(*spheres.back());
+    }
+    else if (token_is(begin, end, "plane"))
+      read = read_object(reader, materials, planes);
+    else if (token_is(begin, end, "light"))
+      read = read_light(reader, scene.world);
+    else if (token_is(begin, end, "material"))
+      read = read_material(reader, materials);
+    else if (token_is(begin, end, "camera"))
+      read = read_camera(reader, scene.camera);
+
+    if (!read || !reader.at_line_end())
+    {
+      std::ostringstream message;
+      message << "line " << reader.line() << ": invalid "
+              << std::string(begin, end) << " statement";
+      a_error = message.str();
+      return false;
+    }
+  }
+  scene.world.set_objects(std::move(spheres), std::move(store), Bvh());
+  for (auto& plane : planes)
+    scene.world.add_object(std::move(plane));
+  auto loaded = std::chrono::steady_clock::now();
+  scene.world.build_bvh();
+  auto built = std::chrono::steady_clock::now();
+
+  std::chrono::duration<double> load_time = loaded - start;
+  std::chrono::duration<double> bvh_time = built - loaded;
+  scene.load_seconds = load_time.count();
+  scene.bvh_seconds = bvh_time.count();
+  a_scene = std::move(scene);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool load_scene(const std::string& a_path, Scene& a_scene,
+    std::string& a_error)
+{
+  auto start = std::chrono::steady_clock::now();
+  std::ifstream file(a_path, std::ios::binary);
+  if (!file)
+  {
+    a_error = "cannot open " + a_path;
+    return false;
+  }
+  std::string text;
+  file.seekg(0, std::ios::end);
+  text.resize(static_cast<size_t>(file.tellg()));
+  file.seekg(0, std::ios::beg);
+  file.read(&text[0], static_cast<std::streamsize>(text.size()));
+  if (!file)
+  {
+    a_error = "cannot read " + a_path;
+    return false;
+  }
+  std::chrono::duration<double> read_time =
+      std::chrono::steady_clock::now() - start;
+
+  if (!parse_scene(text.data(), text.size(), a_scene, a_error))
+  {
+    a_error = a_path + ": " + a_error;
+    return false;
+  }
+  a_scene.load_seconds += read_time.count();
+  return true;
+}
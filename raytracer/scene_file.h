@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <string>
+
+#include <raytracer/camera.h>
+#include <raytracer/world.h>
+
+
+/// Largest camera width or height a scene may give, in pixels.
+const int MAX_CAMERA_SIZE = 65536;
+
+/// A world and the camera it is viewed from, loaded from a scene file.
+///
+/// A scene file is text with one statement per line. Blank lines and text
+/// from a '#' to the end of the line are ignored. Angles are in radians.
+///
+///     camera <width> <height> <field_of_view> from <x> <y> <z>
+///         to <x> <y> <z> up <x> <y> <z>
+///     light <x> <y> <z> <red> <green> <blue>
+///     material <name> [color <red> <green> <blue>] [ambient <value>]
+///         [diffuse <value>] [specular <value>] [shininess <value>]
+///     sphere <material name or -> [<transform>...]
+///     plane <material name or -> [<transform>...]
+///
+/// The camera statement is written on one line, and its width and height
+/// are from 1 to MAX_CAMERA_SIZE. A material must be defined
+/// before the spheres and planes using it. A plane without transforms is
+/// the x-z plane through the origin. The transforms of a sphere or plane are
+/// translate <x> <y> <z>, scale <x> <y> <z>, rotate_x <angle>,
+/// rotate_y <angle>, rotate_z <angle> and
+/// shear <xy> <xz> <yx> <yz> <zx> <zy>. They are multiplied in the order
+/// written, so the last one is applied to the object first.
+struct Scene
+{
+  World world;                                  ///< The objects and lights.
+  Camera camera = Camera(100, 100, M_PI / 3);   ///< The camera.
+  double load_seconds = 0;                      ///< Time to read the scene.
+  double bvh_seconds = 0;                       ///< Time to build the BVH.
+};
+
+/// Load a scene from scene file text. A bounding volume hierarchy is built
+/// over the objects.
+/// \param a_text The scene file text.
+/// \param a_size The number of characters of text.
+/// \param a_scene Receives the scene.
+/// \param a_error Receives a message giving the line of the first error.
+/// \return True if the scene was loaded.
+bool parse_scene(const char* a_text, size_t a_size, Scene& a_scene,
+    std::string& a_error);
+
+/// Load a scene from a scene file. A bounding volume hierarchy is built over
+/// the objects.
+/// \param a_path The path of the scene file.
+/// \param a_scene Receives the scene.
+/// \param a_error Receives a message describing the first error.
+/// \return True if the scene was loaded.
+bool load_scene(const std::string& a_path, Scene& a_scene,
+    std::string& a_error);
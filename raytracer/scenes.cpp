@@ -0,0 +1,126 @@
+#include <raytracer/scenes.h>
+
+#include <cmath>
+
+#include <raytracer/light.h>
+#include <raytracer/material.h>
+#include <raytracer/plane.h>
+#include <raytracer/sphere.h>
+#include <raytracer/transform.h>
+
+
+namespace
+{
+
+//------------------------------------------------------------------------------
+Material room_material()
+{
+  Material material;
+  material.set_color(Color(1, 0.9, 0.9));
+  material.set_specular(0);
+  return material;
+}
+
+//------------------------------------------------------------------------------
+Matrix left_wall_transform()
+{
+  return translation(0, 0, 5) * rotation_y(-M_PI_4) * rotation_x(M_PI_2);
+}
+
+//------------------------------------------------------------------------------
+Matrix right_wall_transform()
+{
+  return translation(0, 0, 5) * rotation_y(M_PI_4) * rotation_x(M_PI_2);
+}
+
+//------------------------------------------------------------------------------
+void add_chapter_7_spheres(World& a_world)
+{
+  auto middle = Sphere::new_ptr();
+  middle->set_transform(translation(-0.5, 1, 0.5));
+  Material middle_material;
+  middle_material.set_color(Color(0.1, 1, 0.5));
+  middle_material.set_diffuse(0.7);
+  middle_material.set_specular(0.3);
+  middle->set_material(middle_material);
+
+  auto right = Sphere::new_ptr();
+  right->set_transform(translation(1.5, 0.5, -0.5) * scaling(0.5, 0.5, 0.5));
+  Material right_material;
+  right_material.set_color(Color(0.5, 1, 0.1));
+  right_material.set_diffuse(0.7);
+  right_material.set_specular(0.3);
+  right->set_material(right_material);
+
+  auto left = Sphere::new_ptr();
+  left->set_transform(translation(-1.5, 0.33, -0.75) *
+                      scaling(0.33, 0.33, 0.33));
+  Material left_material;
+  left_material.set_color(Color(1, 0.8, 0.1));
+  left_material.set_diffuse(0.7);
+  left_material.set_specular(0.3);
+  left->set_material(left_material);
+
+  a_world.add_object(std::move(middle));
+  a_world.add_object(std::move(right));
+  a_world.add_object(std::move(left));
+  a_world.set_light(Light::new_ptr(point(-10, 10, -10), Color(1, 1, 1)));
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------
+World chapter_7_world()
+{
+  World world;
+
+  auto floor = Sphere::new_ptr();
+  floor->set_transform(scaling(10, 0.01, 10));
+  floor->set_material(room_material());
+
+  auto left_wall = Sphere::new_ptr();
+  left_wall->set_transform(left_wall_transform() * scaling(10, 0.01, 10));
+  left_wall->set_material(room_material());
+
+  auto right_wall = Sphere::new_ptr();
+  right_wall->set_transform(right_wall_transform() * scaling(10, 0.01, 10));
+  right_wall->set_material(room_material());
+
+  world.add_object(std::move(floor));
+  world.add_object(std::move(left_wall));
+  world.add_object(std::move(right_wall));
+  add_chapter_7_spheres(world);
+  return world;
+}
+
+//------------------------------------------------------------------------------
+World chapter_9_world()
+{
+  World world;
+
+  auto floor = Plane::new_ptr();
+  floor->set_material(room_material());
+
+  auto left_wall = Plane::new_ptr();
+  left_wall->set_transform(left_wall_transform());
+  left_wall->set_material(room_material());
+
+  auto right_wall = Plane::new_ptr();
+  right_wall->set_transform(right_wall_transform());
+  right_wall->set_material(room_material());
+
+  world.add_object(std::move(floor));
+  world.add_object(std::move(left_wall));
+  world.add_object(std::move(right_wall));
+  add_chapter_7_spheres(world);
+  return world;
+}
+
+//------------------------------------------------------------------------------
+Camera chapter_7_camera(int a_h_size, int a_v_size)
+{
+  Camera camera(a_h_size, a_v_size, M_PI / 3);
+  camera.set_transform(view_transform(point(0, 1.5, -5), point(0, 1, 0),
+                                      vector(0, 1, 0)));
+  return camera;
+}
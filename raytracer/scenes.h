@@ -0,0 +1,20 @@
+#pragma once
+
+#include <raytracer/camera.h>
+#include <raytracer/world.h>
+
+
+/// Get the chapter 7 world: three spheres in a room made of flattened spheres.
+/// \return The chapter 7 world.
+World chapter_7_world();
+
+/// Get the chapter 9 world: the chapter 7 world with its floor and walls
+/// made of planes.
+/// \return The chapter 9 world.
+World chapter_9_world();
+
+/// Get the camera the chapter 7 world is viewed from.
+/// \param a_h_size The horizontal size in pixels.
+/// \param a_v_size The vertical size in pixels.
+/// \return The chapter 7 camera.
+Camera chapter_7_camera(int a_h_size, int a_v_size);
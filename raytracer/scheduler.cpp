@@ -0,0 +1,86 @@
+#include <raytracer/scheduler.h>
+
+#include <thread>
+
+
+//------------------------------------------------------------------------------
+Scheduler::Scheduler(int a_thread_count)
+{
+  if (a_thread_count < 1)
+    a_thread_count = 1;
+  for (int i = 0; i < a_thread_count; ++i)
+  {
+    queues_.push_back(std::make_unique<WorkQueue>());
+  }
+}
+
+//------------------------------------------------------------------------------
+void Scheduler::run(int a_task_count,
+    const std::function<void(int, int)>& a_task)
+{
+  int workers = thread_count();
+  for (int job = 0; job < a_task_count; ++job)
+  {
+    queues_[job % workers]->jobs.push_back(job);
+  }
+
+  std::vector<std::thread> threads;
+  for (int worker = 1; worker < workers; ++worker)
+  {
+    threads.emplace_back(&Scheduler::work, this, worker, std::cref(a_task));
+  }
+  work(0, a_task);
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+}
+
+//------------------------------------------------------------------------------
+void Scheduler::work(int a_worker, const std::function<void(int, int)>& a_task)
+{
+  int job;
+  while (pop(a_worker, job) || steal(a_worker, job))
+  {
+    a_task(job, a_worker);
+  }
+}
+
+//------------------------------------------------------------------------------
+bool Scheduler::pop(int a_worker, int& a_job)
+{
+  WorkQueue& queue = *queues_[a_worker];
+  std::lock_guard<std::mutex> lock(queue.mutex);
+  if (queue.jobs.empty())
+    return false;
+  a_job = queue.jobs.front();
+  queue.jobs.pop_front();
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool Scheduler::steal(int a_worker, int& a_job)
+{
+  // no new tasks are queued while running, so one pass over the other queues
+  // finding nothing means all of the work has been handed out
+  int workers = thread_count();
+  for (int offset = 1; offset < workers; ++offset)
+  {
+    WorkQueue& victim = *queues_[(a_worker + offset) % workers];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.jobs.empty())
+    {
+      a_job = victim.jobs.back();
+      victim.jobs.pop_back();
+      return true;
+    }
+  }
+  return false;
+}
+
+//------------------------------------------------------------------------------
+int hardware_thread_count()
+{
+  int count = static_cast<int>(std::thread::hardware_concurrency());
+  return count > 0 ? count : 1;
+}
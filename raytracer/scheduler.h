@@ -0,0 +1,53 @@
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+/// Runs a fixed set of tasks on a group of threads using work stealing.
+///
+/// Tasks are dealt round-robin to per-worker queues. A worker takes tasks from
+/// the front of its own queue, so tasks start roughly in index order, and once
+/// that is empty steals from the back of the other workers' queues until no
+/// work remains.
+class Scheduler
+{
+public:
+  /// Construct a scheduler.
+  /// \param a_thread_count The number of worker threads (at least 1).
+  explicit Scheduler(int a_thread_count);
+
+  /// Get the number of worker threads.
+  /// \return The number of worker threads.
+  int thread_count() const
+  {
+    return static_cast<int>(queues_.size());
+  }
+
+  /// Run tasks and wait for them all to complete.
+  /// The calling thread is used as one of the workers.
+  /// \param a_task_count The number of tasks to run.
+  /// \param a_task The task to run given a task index and worker index.
+  void run(int a_task_count, const std::function<void(int, int)>& a_task);
+
+private:
+  /// Task queue owned by a single worker.
+  struct WorkQueue
+  {
+    std::mutex mutex;     ///< Guards the task indices.
+    std::deque<int> jobs; ///< Indices of the tasks still to run.
+  };
+
+  void work(int a_worker, const std::function<void(int, int)>& a_task);
+  bool pop(int a_worker, int& a_job);
+  bool steal(int a_worker, int& a_job);
+
+  std::vector<std::unique_ptr<WorkQueue>> queues_; ///< Per-worker queues.
+};
+
+/// Get the number of threads the hardware can run concurrently.
+/// \return The number of hardware threads (at least 1).
+int hardware_thread_count();
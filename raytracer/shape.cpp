@@ -0,0 +1,67 @@
+#include <raytracer/shape.h>
+
+#include <raytracer/intersection.h>
+#include <raytracer/ray.h>
+
+
+//------------------------------------------------------------------------------
+Shape::Shape()
+    : transform_(Matrix::identity_matrix(4))
+      , inverse_transform_(Matrix::identity_matrix(4))
+      , normal_transform_(Matrix::identity_matrix(4))
+{
+}
+
+
+//------------------------------------------------------------------------------
+void Shape::set_transform(const Matrix& a_transform)
+{
+  transform_ = a_transform;
+  inverse_transform_ = transform_.inverse();
+  normal_transform_ = inverse_transform_.transpose();
+}
+
+
+//------------------------------------------------------------------------------
+void Shape::set_transform(const Matrix& a_transform,
+    const Matrix& a_inverse_transform)
+{
+  transform_ = a_transform;
+  inverse_transform_ = a_inverse_transform;
+  normal_transform_ = inverse_transform_.transpose();
+}
+
+
+//------------------------------------------------------------------------------
+void Shape::set_material(const class Material& a_material)
+{
+  material_ = a_material;
+}
+
+
+//------------------------------------------------------------------------------
+Intersections Shape::intersect(const Ray& a_ray) const
+{
+  std::vector<Intersection> intersections;
+  intersect(a_ray, intersections);
+  return intersections;
+}
+
+
+//------------------------------------------------------------------------------
+void Shape::intersect(const Ray& a_ray,
+    std::vector<Intersection>& a_intersections) const
+{
+  local_intersect(a_ray.transform(inverse_transform_), a_intersections);
+}
+
+
+//------------------------------------------------------------------------------
+Tuple Shape::normal_at(Tuple a_world_point) const
+{
+  Tuple object_point = inverse_transform_ * a_world_point;
+  Tuple object_normal = local_normal_at(object_point);
+  Tuple world_normal = normal_transform_ * object_normal;
+  world_normal.set_w(0);
+  return world_normal.normalize();
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <vector>
+
+#include <raytracer/material.h>
+#include <raytracer/matrix.h>
+#include <raytracer/tuple.h>
+
+
+class Intersection;
+
+class Ray;
+
+/// An object of a world: a shape defined in its own object space, placed in
+/// the world by a transform and given a material.
+///
+/// World keeps the objects of each type apart and intersects them through
+/// non-virtual functions of the type, so the virtual functions here are
+/// only used once per hit when shading, and when a single object is asked
+/// for its intersections.
+class Shape
+{
+public:
+  /// Construct a shape with no transform and the default material.
+  Shape();
+
+  virtual ~Shape() = default;
+
+  /// Get the transformation matrix of the shape.
+  /// \return The transformation matrix of the shape.
+  const Matrix& transform() const
+  {
+    return transform_;
+  }
+
+  /// Set the transformation matrix of the shape.
+  /// Also computes the inverse and inverse transpose used when intersecting.
+  /// \param a_transform The new transformation matrix of the shape.
+  void set_transform(const Matrix& a_transform);
+
+  /// Set the transformation matrix of the shape and its inverse, computed
+  /// earlier, such as one read from a scene cache.
+  /// \param a_transform The new transformation matrix of the shape.
+  /// \param a_inverse_transform The inverse of the transformation matrix.
+  void set_transform(const Matrix& a_transform,
+      const Matrix& a_inverse_transform);
+
+  /// Get the inverse of the transformation matrix of the shape.
+  /// \return The inverse transformation matrix.
+  const Matrix& inverse_transform() const
+  {
+    return inverse_transform_;
+  }
+
+  /// Get the transpose of the inverse transformation matrix of the shape.
+  /// \return The matrix to transform object normals to world space.
+  const Matrix& normal_transform() const
+  {
+    return normal_transform_;
+  }
+
+  /// Get the material of the shape.
+  /// \return The material of the shape.
+  const Material& material() const
+  {
+    return material_;
+  }
+
+  /// Set the material of the shape.
+  /// \param a_material The new material of the shape.
+  void set_material(const class Material& a_material);
+
+  /// Determine if two shapes are the same object.
+  /// \param a_rhs The shape to compare against.
+  /// \return True if the two shapes are the same object.
+  bool operator==(const Shape& a_rhs) const
+  {
+    return this == &a_rhs;
+  }
+
+  /// Get the intersections (if any) of the ray and this shape.
+  /// \param a_ray The ray to intersect with the shape.
+  /// \return The intersections of the ray with this shape.
+  std::vector<Intersection> intersect(const Ray& a_ray) const;
+
+  /// Append the intersections (if any) of the ray and this shape to a list.
+  /// Reusing the list between calls avoids allocating once it has grown.
+  /// \param a_ray The ray to intersect with the shape.
+  /// \param a_intersections The list to append the intersections to.
+  void intersect(const Ray& a_ray,
+      std::vector<Intersection>& a_intersections) const;
+
+  /// Get the normal given a point on the surface.
+  /// \param a_world_point The world space point on the shape surface.
+  /// \return The normal vector at the surface of the shape.
+  Tuple normal_at(Tuple a_world_point) const;
+
+  /// Append the intersections (if any) of a ray in object space.
+  /// \param a_local_ray The ray in the object space of the shape.
+  /// \param a_intersections The list to append the intersections to.
+  virtual void local_intersect(const Ray& a_local_ray,
+      std::vector<Intersection>& a_intersections) const = 0;
+
+  /// Get the normal at a point on the surface in object space.
+  /// \param a_local_point The object space point on the shape surface.
+  /// \return The object space normal, not necessarily normalized.
+  virtual Tuple local_normal_at(const Tuple& a_local_point) const = 0;
+
+private:
+  Matrix transform_;         ///< Transformation matrix for object coordinates.
+  Matrix inverse_transform_; ///< Inverse of the transformation matrix.
+  Matrix normal_transform_;  ///< Transpose of the inverse transformation.
+  class Material material_;  ///< The material of the shape.
+};
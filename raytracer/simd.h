@@ -0,0 +1,422 @@
+#pragma once
+
+// Kernels for tuple and color math on arrays of doubles or floats.
+//
+// The instruction set is chosen at build time with the RAYTRACER_SIMD CMake
+// option, which defines RAYTRACER_SIMD_AVX2 or RAYTRACER_SIMD_SSE2. Without
+// either the portable scalar kernels are used. Every backend adds products in
+// the same order as the scalar code so results are identical bit for bit.
+
+#if defined(RAYTRACER_SIMD_AVX2)
+#include <immintrin.h>
+#elif defined(RAYTRACER_SIMD_SSE2)
+#include <emmintrin.h>
+#endif
+
+
+namespace simd
+{
+
+/// Get the name of the instruction set the kernels were built for.
+/// \return "avx2", "sse2" or "scalar".
+inline const char* backend_name()
+{
+#if defined(RAYTRACER_SIMD_AVX2)
+  return "avx2";
+#elif defined(RAYTRACER_SIMD_SSE2)
+  return "sse2";
+#else
+  return "scalar";
+#endif
+}
+
+/// Add two arrays of 4 values.
+/// \param a_lhs The first operand.
+/// \param a_rhs The second operand.
+/// \param a_result Receives the sums.
+inline void add4(const double* a_lhs, const double* a_rhs, double* a_result)
+{
+#if defined(RAYTRACER_SIMD_AVX2)
+  _mm256_storeu_pd(a_result, _mm256_add_pd(_mm256_loadu_pd(a_lhs),
+                                            _mm256_loadu_pd(a_rhs)));
+#elif defined(RAYTRACER_SIMD_SSE2)
+  _mm_storeu_pd(a_result, _mm_add_pd(_mm_loadu_pd(a_lhs),
+                                     _mm_loadu_pd(a_rhs)));
+  _mm_storeu_pd(a_result + 2, _mm_add_pd(_mm_loadu_pd(a_lhs + 2),
+                                         _mm_loadu_pd(a_rhs + 2)));
+#else
+  for (int i = 0; i < 4; ++i)
+    a_result[i] = a_lhs[i] + a_rhs[i];
+#endif
+}
+
+/// Subtract one array of 4 values from another.
+/// \param a_lhs The first operand.
+/// \param a_rhs The second operand.
+/// \param a_result Receives the differences.
+inline void sub4(const double* a_lhs, const double* a_rhs, double* a_result)
+{
+#if defined(RAYTRACER_SIMD_AVX2)
+  _mm256_storeu_pd(a_result, _mm256_sub_pd(_mm256_loadu_pd(a_lhs),
+                                            _mm256_loadu_pd(a_rhs)));
+#elif defined(RAYTRACER_SIMD_SSE2)
+  _mm_storeu_pd(a_result, _mm_sub_pd(_mm_loadu_pd(a_lhs),
+                                     _mm_loadu_pd(a_rhs)));
+  _mm_storeu_pd(a_result + 2, _mm_sub_pd(_mm_loadu_pd(a_lhs + 2),
+                                         _mm_loadu_pd(a_rhs + 2)));
+#else
+  for (int i = 0; i < 4; ++i)
+    a_result[i] = a_lhs[i] - a_rhs[i];
+#endif
+}
+
+/// Multiply an array of 4 values by a scalar.
+/// \param a_lhs The array operand.
+/// \param a_rhs The scalar operand.
+/// \param a_result Receives the products.
+inline void scale4(const double* a_lhs, double a_rhs, double* a_result)
+{
+#if defined(RAYTRACER_SIMD_AVX2)
+  _mm256_storeu_pd(a_result, _mm256_mul_pd(_mm256_loadu_pd(a_lhs),
+                                            _mm256_set1_pd(a_rhs)));
+#elif defined(RAYTRACER_SIMD_SSE2)
+  __m128d scale = _mm_set1_pd(a_rhs);
+  _mm_storeu_pd(a_result, _mm_mul_pd(_mm_loadu_pd(a_lhs), scale));
+  _mm_storeu_pd(a_result + 2, _mm_mul_pd(_mm_loadu_pd(a_lhs + 2), scale));
+#else
+  for (int i = 0; i < 4; ++i)
+    a_result[i] = a_lhs[i] * a_rhs;
+#endif
+}
+
+/// Divide an array of 4 values by a scalar.
+/// \param a_lhs The array operand.
+/// \param a_rhs The scalar operand.
+/// \param a_result Receives the quotients.
+inline void divide4(const double* a_lhs, double a_rhs, double* a_result)
+{
+#if defined(RAYTRACER_SIMD_AVX2)
+  _mm256_storeu_pd(a_result, _mm256_div_pd(_mm256_loadu_pd(a_lhs),
+                                            _mm256_set1_pd(a_rhs)));
+#elif defined(RAYTRACER_SIMD_SSE2)
+  __m128d divisor = _mm_set1_pd(a_rhs);
+  _mm_storeu_pd(a_result, _mm_div_pd(_mm_loadu_pd(a_lhs), divisor));
+  _mm_storeu_pd(a_result + 2, _mm_div_pd(_mm_loadu_pd(a_lhs + 2), divisor));
+#else
+  for (int i = 0; i < 4; ++i)
+    a_result[i] = a_lhs[i] / a_rhs;
+#endif
+}
+
+/// Get the dot product of two arrays of 4 values.
+/// \param a_lhs The first operand.
+/// \param a_rhs The second operand.
+/// \return The sum of the products, added in index order.
+inline double dot4(const double* a_lhs, const double* a_rhs)
+{
+#if defined(RAYTRACER_SIMD_AVX2)
+  __m256d products = _mm256_mul_pd(_mm256_loadu_pd(a_lhs),
+                                   _mm256_loadu_pd(a_rhs));
+  __m128d low = _mm256_castpd256_pd128(products);
+  __m128d high = _mm256_extractf128_pd(products, 1);
+  __m128d sum = _mm_add_sd(low, _mm_unpackhi_pd(low, low));
+  sum = _mm_add_sd(sum, high);
+  sum = _mm_add_sd(sum, _mm_unpackhi_pd(high, high));
+  return _mm_cvtsd_f64(sum);
+#elif defined(RAYTRACER_SIMD_SSE2)
+  __m128d low = _mm_mul_pd(_mm_loadu_pd(a_lhs), _mm_loadu_pd(a_rhs));
+  __m128d high = _mm_mul_pd(_mm_loadu_pd(a_lhs + 2), _mm_loadu_pd(a_rhs + 2));
+  __m128d sum = _mm_add_sd(low, _mm_unpackhi_pd(low, low));
+  sum = _mm_add_sd(sum, high);
+  sum = _mm_add_sd(sum, _mm_unpackhi_pd(high, high));
+  return _mm_cvtsd_f64(sum);
+#else
+  return a_lhs[0] * a_rhs[0] + a_lhs[1] * a_rhs[1] + a_lhs[2] * a_rhs[2] +
+         a_lhs[3] * a_rhs[3];
+#endif
+}
+
+/// Get the cross product of the first 3 of 4 values, with a zero 4th value.
+/// \param a_lhs The first operand.
+/// \param a_rhs The second operand.
+/// \param a_result Receives the cross product.
+inline void cross4(const double* a_lhs, const double* a_rhs, double* a_result)
+{
+#if defined(RAYTRACER_SIMD_AVX2)
+  __m256d lhs = _mm256_loadu_pd(a_lhs);
+  __m256d rhs = _mm256_loadu_pd(a_rhs);
+  // (y, z, x, w) and (z, x, y, w) orderings of each operand
+  __m256d lhs_yzx = _mm256_permute4x64_pd(lhs, _MM_SHUFFLE(3, 0, 2, 1));
+  __m256d lhs_zxy = _mm256_permute4x64_pd(lhs, _MM_SHUFFLE(3, 1, 0, 2));
+  __m256d rhs_yzx = _mm256_permute4x64_pd(rhs, _MM_SHUFFLE(3, 0, 2, 1));
+  __m256d rhs_zxy = _mm256_permute4x64_pd(rhs, _MM_SHUFFLE(3, 1, 0, 2));
+  __m256d cross = _mm256_sub_pd(_mm256_mul_pd(lhs_yzx, rhs_zxy),
+                                _mm256_mul_pd(lhs_zxy, rhs_yzx));
+  _mm256_storeu_pd(a_result,
+                   _mm256_blend_pd(cross, _mm256_setzero_pd(), 0x8));
+#else
+  a_result[0] = a_lhs[1] * a_rhs[2] - a_lhs[2] * a_rhs[1];
+  a_result[1] = a_lhs[2] * a_rhs[0] - a_lhs[0] * a_rhs[2];
+  a_result[2] = a_lhs[0] * a_rhs[1] - a_lhs[1] * a_rhs[0];
+  a_result[3] = 0.0;
+#endif
+}
+
+/// Multiply a 4x4 matrix by an array of 4 values.
+/// \param a_row_0 The first row of the matrix.
+/// \param a_row_1 The second row of the matrix.
+/// \param a_row_2 The third row of the matrix.
+/// \param a_row_3 The fourth row of the matrix.
+/// \param a_rhs The array to multiply.
+/// \param a_result Receives the dot product of each row with the array.
+inline void matrix_times4(const double* a_row_0, const double* a_row_1,
+    const double* a_row_2, const double* a_row_3, const double* a_rhs,
+    double* a_result)
+{
+#if defined(RAYTRACER_SIMD_AVX2)
+  __m256d rhs = _mm256_loadu_pd(a_rhs);
+  __m256d p_0 = _mm256_mul_pd(_mm256_loadu_pd(a_row_0), rhs);
+  __m256d p_1 = _mm256_mul_pd(_mm256_loadu_pd(a_row_1), rhs);
+  __m256d p_2 = _mm256_mul_pd(_mm256_loadu_pd(a_row_2), rhs);
+  __m256d p_3 = _mm256_mul_pd(_mm256_loadu_pd(a_row_3), rhs);
+  // transpose the products so each register holds one column
+  __m256d t_0 = _mm256_unpacklo_pd(p_0, p_1);
+  __m256d t_1 = _mm256_unpackhi_pd(p_0, p_1);
+  __m256d t_2 = _mm256_unpacklo_pd(p_2, p_3);
+  __m256d t_3 = _mm256_unpackhi_pd(p_2, p_3);
+  __m256d c_0 = _mm256_permute2f128_pd(t_0, t_2, 0x20);
+  __m256d c_1 = _mm256_permute2f128_pd(t_1, t_3, 0x20);
+  __m256d c_2 = _mm256_permute2f128_pd(t_0, t_2, 0x31);
+  __m256d c_3 = _mm256_permute2f128_pd(t_1, t_3, 0x31);
+  __m256d sum = _mm256_add_pd(_mm256_add_pd(_mm256_add_pd(c_0, c_1), c_2),
+                              c_3);
+  _mm256_storeu_pd(a_result, sum);
+#elif defined(RAYTRACER_SIMD_SSE2)
+  const double* rows[4] = {a_row_0, a_row_1, a_row_2, a_row_3};
+  __m128d rhs_low = _mm_loadu_pd(a_rhs);
+  __m128d rhs_high = _mm_loadu_pd(a_rhs + 2);
+  for (int row = 0; row < 4; row += 2)
+  {
+    __m128d low_0 = _mm_mul_pd(_mm_loadu_pd(rows[row]), rhs_low);
+    __m128d high_0 = _mm_mul_pd(_mm_loadu_pd(rows[row] + 2), rhs_high);
+    __m128d low_1 = _mm_mul_pd(_mm_loadu_pd(rows[row + 1]), rhs_low);
+    __m128d high_1 = _mm_mul_pd(_mm_loadu_pd(rows[row + 1] + 2), rhs_high);
+    __m128d sum = _mm_add_pd(_mm_unpacklo_pd(low_0, low_1),
+                             _mm_unpackhi_pd(low_0, low_1));
+    sum = _mm_add_pd(sum, _mm_unpacklo_pd(high_0, high_1));
+    sum = _mm_add_pd(sum, _mm_unpackhi_pd(high_0, high_1));
+    _mm_storeu_pd(a_result + row, sum);
+  }
+#else
+  a_result[0] = dot4(a_row_0, a_rhs);
+  a_result[1] = dot4(a_row_1, a_rhs);
+  a_result[2] = dot4(a_row_2, a_rhs);
+  a_result[3] = dot4(a_row_3, a_rhs);
+#endif
+}
+
+/// Add two arrays of 3 values.
+/// \param a_lhs The first operand.
+/// \param a_rhs The second operand.
+/// \param a_result Receives the sums.
+inline void add3(const double* a_lhs, const double* a_rhs, double* a_result)
+{
+#if defined(RAYTRACER_SIMD_AVX2) || defined(RAYTRACER_SIMD_SSE2)
+  _mm_storeu_pd(a_result, _mm_add_pd(_mm_loadu_pd(a_lhs),
+                                     _mm_loadu_pd(a_rhs)));
+#else
+  a_result[0] = a_lhs[0] + a_rhs[0];
+  a_result[1] = a_lhs[1] + a_rhs[1];
+#endif
+  a_result[2] = a_lhs[2] + a_rhs[2];
+}
+
+/// Subtract one array of 3 values from another.
+/// \param a_lhs The first operand.
+/// \param a_rhs The second operand.
+/// \param a_result Receives the differences.
+inline void sub3(const double* a_lhs, const double* a_rhs, double* a_result)
+{
+#if defined(RAYTRACER_SIMD_AVX2) || defined(RAYTRACER_SIMD_SSE2)
+  _mm_storeu_pd(a_result, _mm_sub_pd(_mm_loadu_pd(a_lhs),
+                                     _mm_loadu_pd(a_rhs)));
+#else
+  a_result[0] = a_lhs[0] - a_rhs[0];
+  a_result[1] = a_lhs[1] - a_rhs[1];
+#endif
+  a_result[2] = a_lhs[2] - a_rhs[2];
+}
+
+/// Multiply two arrays of 3 values element by element.
+/// \param a_lhs The first operand.
+/// \param a_rhs The second operand.
+/// \param a_result Receives the products.
+inline void mul3(const double* a_lhs, const double* a_rhs, double* a_result)
+{
+#if defined(RAYTRACER_SIMD_AVX2) || defined(RAYTRACER_SIMD_SSE2)
+  _mm_storeu_pd(a_result, _mm_mul_pd(_mm_loadu_pd(a_lhs),
+                                     _mm_loadu_pd(a_rhs)));
+#else
+  a_result[0] = a_lhs[0] * a_rhs[0];
+  a_result[1] = a_lhs[1] * a_rhs[1];
+#endif
+  a_result[2] = a_lhs[2] * a_rhs[2];
+}
+
+/// Multiply an array of 3 values by a scalar.
+/// \param a_lhs The array operand.
+/// \param a_rhs The scalar operand.
+/// \param a_result Receives the products.
+inline void scale3(const double* a_lhs, double a_rhs, double* a_result)
+{
+#if defined(RAYTRACER_SIMD_AVX2) || defined(RAYTRACER_SIMD_SSE2)
+  _mm_storeu_pd(a_result, _mm_mul_pd(_mm_loadu_pd(a_lhs),
+                                     _mm_set1_pd(a_rhs)));
+#else
+  a_result[0] = a_lhs[0] * a_rhs;
+  a_result[1] = a_lhs[1] * a_rhs;
+#endif
+  a_result[2] = a_lhs[2] * a_rhs;
+}
+
+// Single precision kernels. Four floats fill one 128-bit register, so the
+// SSE instructions serve both the sse2 and avx2 backends.
+
+/// \copydoc add4(const double*, const double*, double*)
+inline void add4(const float* a_lhs, const float* a_rhs, float* a_result)
+{
+#if defined(RAYTRACER_SIMD_AVX2) || defined(RAYTRACER_SIMD_SSE2)
+  _mm_storeu_ps(a_result, _mm_add_ps(_mm_loadu_ps(a_lhs),
+                                     _mm_loadu_ps(a_rhs)));
+#else
+  for (int i = 0; i < 4; ++i)
+    a_result[i] = a_lhs[i] + a_rhs[i];
+#endif
+}
+
+/// \copydoc sub4(const double*, const double*, double*)
+inline void sub4(const float* a_lhs, const float* a_rhs, float* a_result)
+{
+#if defined(RAYTRACER_SIMD_AVX2) || defined(RAYTRACER_SIMD_SSE2)
+  _mm_storeu_ps(a_result, _mm_sub_ps(_mm_loadu_ps(a_lhs),
+                                     _mm_loadu_ps(a_rhs)));
+#else
+  for (int i = 0; i < 4; ++i)
+    a_result[i] = a_lhs[i] - a_rhs[i];
+#endif
+}
+
+/// \copydoc scale4(const double*, double, double*)
+inline void scale4(const float* a_lhs, float a_rhs, float* a_result)
+{
+#if defined(RAYTRACER_SIMD_AVX2) || defined(RAYTRACER_SIMD_SSE2)
+  _mm_storeu_ps(a_result, _mm_mul_ps(_mm_loadu_ps(a_lhs),
+                                     _mm_set1_ps(a_rhs)));
+#else
+  for (int i = 0; i < 4; ++i)
+    a_result[i] = a_lhs[i] * a_rhs;
+#endif
+}
+
+/// \copydoc divide4(const double*, double, double*)
+inline void divide4(const float* a_lhs, float a_rhs, float* a_result)
+{
+#if defined(RAYTRACER_SIMD_AVX2) || defined(RAYTRACER_SIMD_SSE2)
+  _mm_storeu_ps(a_result, _mm_div_ps(_mm_loadu_ps(a_lhs),
+                                     _mm_set1_ps(a_rhs)));
+#else
+  for (int i = 0; i < 4; ++i)
+    a_result[i] = a_lhs[i] / a_rhs;
+#endif
+}
+
+/// \copydoc dot4(const double*, const double*)
+inline float dot4(const float* a_lhs, const float* a_rhs)
+{
+#if defined(RAYTRACER_SIMD_AVX2) || defined(RAYTRACER_SIMD_SSE2)
+  __m128 products = _mm_mul_ps(_mm_loadu_ps(a_lhs), _mm_loadu_ps(a_rhs));
+  __m128 sum = _mm_add_ss(products, _mm_shuffle_ps(products, products, 1));
+  sum = _mm_add_ss(sum, _mm_shuffle_ps(products, products, 2));
+  sum = _mm_add_ss(sum, _mm_shuffle_ps(products, products, 3));
+  return _mm_cvtss_f32(sum);
+#else
+  return a_lhs[0] * a_rhs[0] + a_lhs[1] * a_rhs[1] + a_lhs[2] * a_rhs[2] +
+         a_lhs[3] * a_rhs[3];
+#endif
+}
+
+/// \copydoc cross4(const double*, const double*, double*)
+inline void cross4(const float* a_lhs, const float* a_rhs, float* a_result)
+{
+#if defined(RAYTRACER_SIMD_AVX2) || defined(RAYTRACER_SIMD_SSE2)
+  __m128 lhs = _mm_loadu_ps(a_lhs);
+  __m128 rhs = _mm_loadu_ps(a_rhs);
+  // (y, z, x, w) and (z, x, y, w) orderings of each operand
+  __m128 lhs_yzx = _mm_shuffle_ps(lhs, lhs, _MM_SHUFFLE(3, 0, 2, 1));
+  __m128 lhs_zxy = _mm_shuffle_ps(lhs, lhs, _MM_SHUFFLE(3, 1, 0, 2));
+  __m128 rhs_yzx = _mm_shuffle_ps(rhs, rhs, _MM_SHUFFLE(3, 0, 2, 1));
+  __m128 rhs_zxy = _mm_shuffle_ps(rhs, rhs, _MM_SHUFFLE(3, 1, 0, 2));
+  __m128 cross = _mm_sub_ps(_mm_mul_ps(lhs_yzx, rhs_zxy),
+                            _mm_mul_ps(lhs_zxy, rhs_yzx));
+  __m128 xyz_mask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+  _mm_storeu_ps(a_result, _mm_and_ps(cross, xyz_mask));
+#else
+  a_result[0] = a_lhs[1] * a_rhs[2] - a_lhs[2] * a_rhs[1];
+  a_result[1] = a_lhs[2] * a_rhs[0] - a_lhs[0] * a_rhs[2];
+  a_result[2] = a_lhs[0] * a_rhs[1] - a_lhs[1] * a_rhs[0];
+  a_result[3] = 0.0f;
+#endif
+}
+
+/// \copydoc matrix_times4(const double*, const double*, const double*, const double*, const double*, double*)
+inline void matrix_times4(const float* a_row_0, const float* a_row_1,
+    const float* a_row_2, const float* a_row_3, const float* a_rhs,
+    float* a_result)
+{
+#if defined(RAYTRACER_SIMD_AVX2) || defined(RAYTRACER_SIMD_SSE2)
+  __m128 rhs = _mm_loadu_ps(a_rhs);
+  __m128 c_0 = _mm_mul_ps(_mm_loadu_ps(a_row_0), rhs);
+  __m128 c_1 = _mm_mul_ps(_mm_loadu_ps(a_row_1), rhs);
+  __m128 c_2 = _mm_mul_ps(_mm_loadu_ps(a_row_2), rhs);
+  __m128 c_3 = _mm_mul_ps(_mm_loadu_ps(a_row_3), rhs);
+  // transpose the products so each register holds one column
+  _MM_TRANSPOSE4_PS(c_0, c_1, c_2, c_3);
+  _mm_storeu_ps(a_result,
+                _mm_add_ps(_mm_add_ps(_mm_add_ps(c_0, c_1), c_2), c_3));
+#else
+  a_result[0] = dot4(a_row_0, a_rhs);
+  a_result[1] = dot4(a_row_1, a_rhs);
+  a_result[2] = dot4(a_row_2, a_rhs);
+  a_result[3] = dot4(a_row_3, a_rhs);
+#endif
+}
+
+/// \copydoc add3(const double*, const double*, double*)
+inline void add3(const float* a_lhs, const float* a_rhs, float* a_result)
+{
+  for (int i = 0; i < 3; ++i)
+    a_result[i] = a_lhs[i] + a_rhs[i];
+}
+
+/// \copydoc sub3(const double*, const double*, double*)
+inline void sub3(const float* a_lhs, const float* a_rhs, float* a_result)
+{
+  for (int i = 0; i < 3; ++i)
+    a_result[i] = a_lhs[i] - a_rhs[i];
+}
+
+/// \copydoc mul3(const double*, const double*, double*)
+inline void mul3(const float* a_lhs, const float* a_rhs, float* a_result)
+{
+  for (int i = 0; i < 3; ++i)
+    a_result[i] = a_lhs[i] * a_rhs[i];
+}
+
+/// \copydoc scale3(const double*, double, double*)
+inline void scale3(const float* a_lhs, float a_rhs, float* a_result)
+{
+  for (int i = 0; i < 3; ++i)
+    a_result[i] = a_lhs[i] * a_rhs;
+}
+
+} // namespace simd
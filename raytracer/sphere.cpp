@@ -3,82 +3,182 @@
 #include <raytracer/sphere.h>
 
 #include <algorithm>
+#include <utility>
 
 #include <raytracer/intersection.h>
+#include <raytracer/render_stats.h>
 
 
+namespace
+{
+
 //------------------------------------------------------------------------------
-std::unique_ptr<Sphere> Sphere::new_ptr()
+/// Get the distances (if any) along a ray in sphere coordinates where it
+/// meets the unit sphere.
+bool intersect_unit_sphere(const Ray& a_ray_sphere, Scalar& a_t_1,
+    Scalar& a_t_2)
 {
-  return std::make_unique<Sphere>();
+  Tuple sphere_to_ray = a_ray_sphere.origin() - point(0, 0, 0);
+  Scalar a = dot(a_ray_sphere.direction(), a_ray_sphere.direction());
+  Scalar b = 2 * dot(a_ray_sphere.direction(), sphere_to_ray);
+  Scalar c = dot(sphere_to_ray, sphere_to_ray) - 1;
+  Scalar discriminant = b * b - 4 * a * c;
+  stats::count(&RenderStats::sphere_intersects);
+  if (discriminant < 0)
+    return false;
+
+  stats::count(&RenderStats::sphere_hits);
+
+  a_t_1 = (-b - std::sqrt(discriminant)) / (2 * a);
+  a_t_2 = (-b + std::sqrt(discriminant)) / (2 * a);
+  if (a_t_1 > a_t_2)
+    std::swap(a_t_1, a_t_2);
+  return true;
 }
 
+} // namespace
 
 //------------------------------------------------------------------------------
-Sphere::Sphere()
-    : transform_(Matrix::identity_matrix(4))
+std::unique_ptr<Sphere> Sphere::new_ptr()
 {
+  return std::make_unique<Sphere>();
 }
 
 
 //------------------------------------------------------------------------------
-Matrix Sphere::transform() const
+void Sphere::local_intersect(const Ray& a_local_ray,
+    std::vector<Intersection>& a_intersections) const
 {
-  return transform_;
+  Scalar t_1;
+  Scalar t_2;
+  if (intersect_unit_sphere(a_local_ray, t_1, t_2))
+  {
+    a_intersections.emplace_back(t_1, *this);
+    a_intersections.emplace_back(t_2, *this);
+  }
 }
 
 
 //------------------------------------------------------------------------------
-void Sphere::set_transform(const Matrix& a_transform)
+bool Sphere::intersect_distances(const Ray& a_ray, Scalar& a_t_1,
+    Scalar& a_t_2) const
 {
-  transform_ = a_transform;
+  // use a ray translated to sphere coordinates to intersect
+  Ray ray_sphere = a_ray.transform(inverse_transform());
+  return intersect_unit_sphere(ray_sphere, a_t_1, a_t_2);
 }
 
+//------------------------------------------------------------------------------
+bool Sphere::intersect_distances(const Scalar* a_inverse_transform,
+    const Ray& a_ray, Scalar& a_t_1, Scalar& a_t_2)
+{
+  const Scalar* m = a_inverse_transform;
+  Tuple origin;
+  Tuple direction;
+  simd::matrix_times4(m, m + 4, m + 8, m + 12, a_ray.origin().data(),
+                      origin.data());
+  simd::matrix_times4(m, m + 4, m + 8, m + 12, a_ray.direction().data(),
+                      direction.data());
+  return intersect_unit_sphere(Ray(origin, direction), a_t_1, a_t_2);
+}
 
 //------------------------------------------------------------------------------
-Material Sphere::material() const
+template <int N>
+void Sphere::intersect_packet(const Scalar* a_inverse_transform,
+    const RayPacket<N>& a_packet, RayPacketHits<N>& a_hits)
 {
-  return material_;
+  Scalar m[4][4];
+  for (int row = 0; row < 4; ++row)
+  {
+    for (int col = 0; col < 4; ++col)
+      m[row][col] = a_inverse_transform[row * 4 + col];
+  }
+
+  // the same steps as intersect_distances() written over lanes so that the
+  // compiler can vectorize them
+  for (int i = 0; i < N; ++i)
+  {
+    Scalar o_x = a_packet.origin_x[i];
+    Scalar o_y = a_packet.origin_y[i];
+    Scalar o_z = a_packet.origin_z[i];
+    Scalar o_w = a_packet.origin_w[i];
+    Scalar d_x = a_packet.direction_x[i];
+    Scalar d_y = a_packet.direction_y[i];
+    Scalar d_z = a_packet.direction_z[i];
+    Scalar d_w = a_packet.direction_w[i];
+
+    // ray transformed to sphere coordinates, relative to the sphere center
+    Scalar s_x = m[0][0] * o_x + m[0][1] * o_y + m[0][2] * o_z + m[0][3] * o_w;
+    Scalar s_y = m[1][0] * o_x + m[1][1] * o_y + m[1][2] * o_z + m[1][3] * o_w;
+    Scalar s_z = m[2][0] * o_x + m[2][1] * o_y + m[2][2] * o_z + m[2][3] * o_w;
+    Scalar s_w = m[3][0] * o_x + m[3][1] * o_y + m[3][2] * o_z + m[3][3] * o_w -
+                 Scalar(1);
+    Scalar r_x = m[0][0] * d_x + m[0][1] * d_y + m[0][2] * d_z + m[0][3] * d_w;
+    Scalar r_y = m[1][0] * d_x + m[1][1] * d_y + m[1][2] * d_z + m[1][3] * d_w;
+    Scalar r_z = m[2][0] * d_x + m[2][1] * d_y + m[2][2] * d_z + m[2][3] * d_w;
+    Scalar r_w = m[3][0] * d_x + m[3][1] * d_y + m[3][2] * d_z + m[3][3] * d_w;
+
+    Scalar a = r_x * r_x + r_y * r_y + r_z * r_z + r_w * r_w;
+    Scalar b = 2 * (r_x * s_x + r_y * s_y + r_z * s_z + r_w * s_w);
+    Scalar c = (s_x * s_x + s_y * s_y + s_z * s_z + s_w * s_w) - 1;
+    Scalar discriminant = b * b - 4 * a * c;
+    bool miss = discriminant < 0;
+    Scalar root = std::sqrt(miss ? Scalar(0) : discriminant);
+    Scalar t_1 = (-b - root) / (2 * a);
+    Scalar t_2 = (-b + root) / (2 * a);
+    a_hits.hit[i] = !miss;
+    a_hits.t_1[i] = t_1 > t_2 ? t_2 : t_1;
+    a_hits.t_2[i] = t_1 > t_2 ? t_1 : t_2;
+  }
+
+  if (RenderStats::enabled)
+  {
+    int hits = 0;
+    for (int lane = 0; lane < a_packet.count; ++lane)
+      hits += a_hits.hit[lane] ? 1 : 0;
+    stats::count(&RenderStats::sphere_intersects, a_packet.count);
+    stats::count(&RenderStats::sphere_hits, hits);
+  }
 }
 
+template void Sphere::intersect_packet(const Scalar*, const RayPacket<4>&,
+    RayPacketHits<4>&);
+template void Sphere::intersect_packet(const Scalar*, const RayPacket<8>&,
+    RayPacketHits<8>&);
+template void Sphere::intersect_packet(const Scalar*, const RayPacket<16>&,
+    RayPacketHits<16>&);
 
 //------------------------------------------------------------------------------
-void Sphere::set_material(const class Material& a_material)
+template <int N>
+void Sphere::intersect_packet(const RayPacket<N>& a_packet,
+    RayPacketHits<N>& a_hits) const
 {
-  material_ = a_material;
+  Scalar m[16];
+  for (int row = 0; row < 4; ++row)
+  {
+    for (int col = 0; col < 4; ++col)
+      m[row * 4 + col] = inverse_transform()[row][col];
+  }
+  intersect_packet(m, a_packet, a_hits);
 }
 
+template void Sphere::intersect_packet(const RayPacket<4>&,
+    RayPacketHits<4>&) const;
+template void Sphere::intersect_packet(const RayPacket<8>&,
+    RayPacketHits<8>&) const;
+template void Sphere::intersect_packet(const RayPacket<16>&,
+    RayPacketHits<16>&) const;
 
 //------------------------------------------------------------------------------
-Intersections Sphere::intersect(const Ray& a_ray) const
+Bounds Sphere::bounds() const
 {
-  // use a ray translated to sphere coordinates to intersect
-  Ray ray_sphere = a_ray.transform(transform().inverse());
-  std::vector<Intersection> intersections;
-  Tuple sphere_to_ray = ray_sphere.origin() - point(0, 0, 0);
-  double a = dot(ray_sphere.direction(), ray_sphere.direction());
-  double b = 2 * dot(ray_sphere.direction(), sphere_to_ray);
-  double c = dot(sphere_to_ray, sphere_to_ray) - 1;
-  double discriminant = b * b - 4 * a * c;
-  if (discriminant < 0)
-    return intersections;
-
-  double t_1 = (-b - sqrt(discriminant)) / (2 * a);
-  double t_2 = (-b + sqrt(discriminant)) / (2 * a);
-  if (t_1 > t_2)
-    std::swap(t_1, t_2);
-  intersections = {{t_1, *this},
-                   {t_2, *this}};
-  return intersections;
+  Bounds object_bounds(point(-1, -1, -1), point(1, 1, 1));
+  return object_bounds.transform(transform());
 }
 
 
 //------------------------------------------------------------------------------
-Tuple Sphere::normal_at(Tuple a_world_point) const
+Tuple Sphere::local_normal_at(const Tuple& a_local_point) const
 {
-  Tuple object_point = transform().inverse() * a_world_point;
-  Tuple object_normal = object_point - point(0, 0, 0);
-  Tuple world_normal = transform().inverse().transpose() * object_normal;
-  world_normal.set_w(0);
-  return world_normal.normalize();
+  return a_local_point - point(0, 0, 0);
 }
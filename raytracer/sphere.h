@@ -3,8 +3,9 @@
 #include <cmath>
 #include <vector>
 
-#include <raytracer/material.h>
-#include <raytracer/matrix.h>
+#include <raytracer/bounds.h>
+#include <raytracer/ray_packet.h>
+#include <raytracer/shape.h>
 #include <raytracer/tuple.h>
 #include <raytracer/world.h>
 
@@ -13,52 +14,63 @@ class Intersection;
 
 class Ray;
 
-/// A sphere object.
-class Sphere
+/// A unit sphere at the origin of its object space.
+class Sphere : public Shape
 {
 public:
   /// Construct a Sphere shared pointer.
   /// \return The Sphere shared pointer.
   static std::unique_ptr<Sphere> new_ptr();
 
-  /// Construct a unit sphere at the origin
-  Sphere();
-
-  /// Get the transformation matrix of the sphere.
-  /// \return The transformation matrix of the sphere.
-  Matrix transform() const;
-
-  /// Set the transformation matrix of the sphere.
-  /// \param a_transform The new transformation matrix of the sphere.
-  void set_transform(const Matrix& a_transform);
+  /// Get the distances (if any) along the ray where it meets this sphere.
+  /// \param a_ray The ray to intersect with the sphere.
+  /// \param a_t_1 Receives the nearer distance.
+  /// \param a_t_2 Receives the farther distance.
+  /// \return True if the ray meets the sphere.
+  bool intersect_distances(const Ray& a_ray, Scalar& a_t_1,
+      Scalar& a_t_2) const;
 
-  /// Get the material of the sphere.
-  /// \return The material of the sphere.
-  Material material() const;
+  /// Get the distances along each ray of a packet where it meets this sphere.
+  /// Every lane gets the same result as intersect_distances() would give.
+  /// \param a_packet The rays to intersect with the sphere.
+  /// \param a_hits Receives the distances and which lanes hit.
+  template <int N>
+  void intersect_packet(const RayPacket<N>& a_packet,
+      RayPacketHits<N>& a_hits) const;
 
-  /// Set the material of the sphere.
-  /// \param a_material The new material of the sphere.
-  void set_material(const class Material& a_material);
+  /// Get the distances (if any) along the ray where it meets a sphere given
+  /// only its inverse transform.
+  /// \param a_inverse_transform The 16 values of the inverse transform of
+  /// the sphere, row by row.
+  /// \param a_ray The ray to intersect with the sphere.
+  /// \param a_t_1 Receives the nearer distance.
+  /// \param a_t_2 Receives the farther distance.
+  /// \return True if the ray meets the sphere.
+  static bool intersect_distances(const Scalar* a_inverse_transform,
+      const Ray& a_ray, Scalar& a_t_1, Scalar& a_t_2);
 
-  /// Determine if two spheres are the same object.
-  /// \param a_rhs The sphere to compare against.
-  /// \return True if the two spheres are the same object.
-  bool operator==(const Sphere& a_rhs) const
-  {
-    return this == &a_rhs;
-  }
+  /// Get the distances along each ray of a packet where it meets a sphere
+  /// given only its inverse transform.
+  /// \param a_inverse_transform The 16 values of the inverse transform of
+  /// the sphere, row by row.
+  /// \param a_packet The rays to intersect with the sphere.
+  /// \param a_hits Receives the distances and which lanes hit.
+  template <int N>
+  static void intersect_packet(const Scalar* a_inverse_transform,
+      const RayPacket<N>& a_packet, RayPacketHits<N>& a_hits);
 
-  /// Get the intersections (if any) of the ray and this sphere.
-  /// \param a_ray The ray to intersect with the sphere.
-  /// \return The intersections of the ray with this sphere.
-  std::vector<Intersection> intersect(const Ray& a_ray) const;
+  /// Get the world space bounding box of the sphere.
+  /// \return The bounds of the transformed sphere.
+  Bounds bounds() const;
 
-  /// Get the normal given a point on the surface.
-  /// \param a_world_point The world space point on the sphere surface
-  /// \return The normal vector at the surface of the sphere.
-  Tuple normal_at(Tuple a_world_point) const;
+  /// Append the intersections (if any) of a ray in sphere coordinates.
+  /// \param a_local_ray The ray in the object space of the sphere.
+  /// \param a_intersections The list to append the intersections to.
+  void local_intersect(const Ray& a_local_ray,
+      std::vector<Intersection>& a_intersections) const override;
 
-private:
-  Matrix transform_;        ///< Transformation matrix for sphere coordinates.
-  class Material material_; ///< The material of the sphere.
+  /// Get the normal at a point on the surface in sphere coordinates.
+  /// \param a_local_point The object space point on the sphere surface.
+  /// \return The object space normal.
+  Tuple local_normal_at(const Tuple& a_local_point) const override;
 };
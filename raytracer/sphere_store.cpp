@@ -0,0 +1,84 @@
+#include <raytracer/sphere_store.h>
+
+#include <algorithm>
+
+#include <raytracer/sphere.h>
+
+
+//------------------------------------------------------------------------------
+void SphereStore::build(const std::vector<std::unique_ptr<Sphere>>& a_spheres)
+{
+  clear();
+  reserve(static_cast<int>(a_spheres.size()));
+  for (const auto& sphere : a_spheres)
+    add(*sphere);
+}
+
+//------------------------------------------------------------------------------
+void SphereStore::add(const Sphere& a_sphere)
+{
+  const Matrix& inverse = a_sphere.inverse_transform();
+  for (int row = 0; row < 4; ++row)
+  {
+    const Scalar* values = inverse[row].data();
+    inverse_transforms_.insert(inverse_transforms_.end(), values, values + 4);
+  }
+  bounds_.push_back(a_sphere.bounds());
+}
+
+//------------------------------------------------------------------------------
+void SphereStore::set(int a_index, const Sphere& a_sphere)
+{
+  const Matrix& inverse = a_sphere.inverse_transform();
+  Scalar* values = &inverse_transforms_[a_index * 16];
+  for (int row = 0; row < 4; ++row)
+    std::copy(inverse[row].data(), inverse[row].data() + 4, values + row * 4);
+  bounds_[a_index] = a_sphere.bounds();
+}
+
+//------------------------------------------------------------------------------
+void SphereStore::assign(const Scalar* a_inverse_transforms,
+    const Bounds* a_bounds, int a_count)
+{
+  inverse_transforms_.assign(a_inverse_transforms,
+                             a_inverse_transforms + a_count * 16);
+  bounds_.assign(a_bounds, a_bounds + a_count);
+}
+
+//------------------------------------------------------------------------------
+void SphereStore::reserve(int a_count)
+{
+  inverse_transforms_.reserve(static_cast<size_t>(a_count) * 16);
+  bounds_.reserve(static_cast<size_t>(a_count));
+}
+
+//------------------------------------------------------------------------------
+void SphereStore::clear()
+{
+  inverse_transforms_.clear();
+  bounds_.clear();
+}
+
+//------------------------------------------------------------------------------
+bool SphereStore::intersect_distances(int a_index, const Ray& a_ray,
+    Scalar& a_t_1, Scalar& a_t_2) const
+{
+  return Sphere::intersect_distances(&inverse_transforms_[a_index * 16],
+                                     a_ray, a_t_1, a_t_2);
+}
+
+//------------------------------------------------------------------------------
+template <int N>
+void SphereStore::intersect_packet(int a_index, const RayPacket<N>& a_packet,
+    RayPacketHits<N>& a_hits) const
+{
+  Sphere::intersect_packet(&inverse_transforms_[a_index * 16], a_packet,
+                           a_hits);
+}
+
+template void SphereStore::intersect_packet(int, const RayPacket<4>&,
+    RayPacketHits<4>&) const;
+template void SphereStore::intersect_packet(int, const RayPacket<8>&,
+    RayPacketHits<8>&) const;
+template void SphereStore::intersect_packet(int, const RayPacket<16>&,
+    RayPacketHits<16>&) const;
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <raytracer/bounds.h>
+#include <raytracer/ray.h>
+#include <raytracer/ray_packet.h>
+#include <raytracer/scalar.h>
+
+
+class Sphere;
+
+/// Compact copy of the sphere data needed to intersect rays, kept apart
+/// from the transforms and materials used for shading.
+///
+/// The inverse transforms and bounds of all spheres are stored in two
+/// parallel arrays indexed by object, so testing a sphere reads 128
+/// contiguous bytes rather than a whole Sphere.
+class SphereStore
+{
+public:
+  /// Copy the intersection data of a list of spheres.
+  /// \param a_spheres The spheres in object order.
+  void build(const std::vector<std::unique_ptr<Sphere>>& a_spheres);
+
+  /// Copy the intersection data of one more sphere.
+  /// \param a_sphere The sphere to append.
+  void add(const Sphere& a_sphere);
+
+  /// Copy the intersection data of a sphere again after it has changed.
+  /// \param a_index The index of the sphere.
+  /// \param a_sphere The changed sphere.
+  void set(int a_index, const Sphere& a_sphere);
+
+  /// Replace the spheres with intersection data copied earlier, such as
+  /// from a scene cache.
+  /// \param a_inverse_transforms The 16 values of the inverse transform of
+  /// each sphere, row by row.
+  /// \param a_bounds The world space bounds of each sphere.
+  /// \param a_count The number of spheres.
+  void assign(const Scalar* a_inverse_transforms, const Bounds* a_bounds,
+      int a_count);
+
+  /// Reserve room for a number of spheres.
+  /// \param a_count The number of spheres.
+  void reserve(int a_count);
+
+  /// Remove all spheres.
+  void clear();
+
+  /// Get the number of spheres in the store.
+  /// \return The number of spheres.
+  int size() const
+  {
+    return static_cast<int>(bounds_.size());
+  }
+
+  /// Get the inverse transforms of every sphere.
+  /// \return 16 values per sphere, row by row, in object order.
+  const std::vector<Scalar>& inverse_transforms() const
+  {
+    return inverse_transforms_;
+  }
+
+  /// Get the world space bounds of every sphere.
+  /// \return The bounds in object order.
+  const std::vector<Bounds>& bounds() const
+  {
+    return bounds_;
+  }
+
+  /// Get the distances (if any) along the ray where it meets a sphere.
+  /// Gives the same result as Sphere::intersect_distances().
+  /// \param a_index The index of the sphere.
+  /// \param a_ray The ray to intersect with the sphere.
+  /// \param a_t_1 Receives the nearer distance.
+  /// \param a_t_2 Receives the farther distance.
+  /// \return True if the ray meets the sphere.
+  bool intersect_distances(int a_index, const Ray& a_ray, Scalar& a_t_1,
+      Scalar& a_t_2) const;
+
+  /// Get the distances along each ray of a packet where it meets a sphere.
+  /// Gives the same result as Sphere::intersect_packet().
+  /// \param a_index The index of the sphere.
+  /// \param a_packet The rays to intersect with the sphere.
+  /// \param a_hits Receives the distances and which lanes hit.
+  template <int N>
+  void intersect_packet(int a_index, const RayPacket<N>& a_packet,
+      RayPacketHits<N>& a_hits) const;
+
+private:
+  std::vector<Scalar> inverse_transforms_; ///< 16 values per sphere.
+  std::vector<Bounds> bounds_;             ///< World bounds per sphere.
+};
@@ -0,0 +1,399 @@
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+
+#include <raytracer/tuple.h>
+
+#undef minor
+#undef major
+
+template <size_t N>
+class SquareMatrix;
+
+namespace detail
+{
+/// Determinant by cofactor expansion along the first row.
+template <size_t N>
+struct Determinant
+{
+  static constexpr Scalar of(const SquareMatrix<N>& a_matrix)
+  {
+    Scalar det = 0;
+    for (size_t col = 0; col < N; ++col)
+    {
+      det += a_matrix(0, col) * a_matrix.cofactor(0, col);
+    }
+    return det;
+  }
+};
+
+/// Determinant of a 2x2 matrix.
+template <>
+struct Determinant<2>
+{
+  static constexpr Scalar of(const SquareMatrix<2>& a_matrix);
+};
+
+/// Determinant of a 1x1 matrix.
+template <>
+struct Determinant<1>
+{
+  static constexpr Scalar of(const SquareMatrix<1>& a_matrix);
+};
+
+/// Inverse from the transposed cofactors divided by the determinant.
+template <size_t N>
+struct Inverse
+{
+  static constexpr SquareMatrix<N> of(const SquareMatrix<N>& a_matrix)
+  {
+    SquareMatrix<N> a;
+    Scalar det = a_matrix.determinant();
+    for (size_t row = 0; row < N; ++row)
+    {
+      for (size_t col = 0; col < N; ++col)
+      {
+        // note that "col, row" here, instead of "row, col",
+        // accomplishes the transpose operation!
+        a(col, row) = a_matrix.cofactor(row, col) / det;
+      }
+    }
+    return a;
+  }
+};
+
+/// Inverse of a 4x4 matrix in closed form.
+template <>
+struct Inverse<4>
+{
+  static constexpr SquareMatrix<4> of(const SquareMatrix<4>& a_matrix);
+};
+} // namespace detail
+
+/// A matrix with a compile time number of rows and columns.
+///
+/// The size being fixed lets the compiler unroll every loop, and all of the
+/// operations can be evaluated at compile time.
+template <size_t N>
+class SquareMatrix
+{
+public:
+  /// Construct a matrix filled with zeros.
+  constexpr SquareMatrix()
+      : m_{}
+  {
+  }
+
+  /// Construct a matrix from rows of values.
+  /// Missing values are zero and extra values are ignored.
+  /// \param a_rows The rows of the matrix.
+  constexpr SquareMatrix(
+      std::initializer_list<std::initializer_list<Scalar>> a_rows)
+      : m_{}
+  {
+    size_t row = 0;
+    for (auto& values : a_rows)
+    {
+      size_t col = 0;
+      for (Scalar value : values)
+      {
+        if (row < N && col < N)
+          m_[row][col] = value;
+        ++col;
+      }
+      ++row;
+    }
+  }
+
+  /// Get the number of rows and columns of the matrix.
+  /// \return The number of rows and columns.
+  static constexpr size_t size()
+  {
+    return N;
+  }
+
+  /// Get the elements of a row.
+  /// \param a_row The row index.
+  /// \return Pointer to the N elements of the row.
+  constexpr const Scalar* row(size_t a_row) const
+  {
+    return m_[a_row];
+  }
+
+  /// Get an element of the matrix.
+  /// \param a_row The row of the element.
+  /// \param a_col The column of the element.
+  /// \return The element value.
+  constexpr Scalar operator()(size_t a_row, size_t a_col) const
+  {
+    return m_[a_row][a_col];
+  }
+
+  /// Get an element of the matrix for writing.
+  /// \param a_row The row of the element.
+  /// \param a_col The column of the element.
+  /// \return The element.
+  constexpr Scalar& operator()(size_t a_row, size_t a_col)
+  {
+    return m_[a_row][a_col];
+  }
+
+  /// Determine if two matrices are exactly equal.
+  /// \param a_rhs The matrix to compare against.
+  /// \return True if all of the elements are equal.
+  constexpr bool operator==(const SquareMatrix& a_rhs) const
+  {
+    for (size_t row = 0; row < N; ++row)
+    {
+      for (size_t col = 0; col < N; ++col)
+      {
+        if (m_[row][col] != a_rhs.m_[row][col])
+          return false;
+      }
+    }
+    return true;
+  }
+
+  /// Determine if two matrices are not exactly equal.
+  /// \param a_rhs The matrix to compare against.
+  /// \return True if any of the elements differ.
+  constexpr bool operator!=(const SquareMatrix& a_rhs) const
+  {
+    return !(*this == a_rhs);
+  }
+
+  /// Get an identity matrix.
+  /// \return The identity matrix.
+  static constexpr SquareMatrix identity()
+  {
+    SquareMatrix a;
+    for (size_t i = 0; i < N; ++i)
+    {
+      a.m_[i][i] = 1;
+    }
+    return a;
+  }
+
+  /// Get the transpose of the matrix.
+  /// \return The transpose of the matrix.
+  constexpr SquareMatrix transpose() const
+  {
+    SquareMatrix a;
+    for (size_t row = 0; row < N; ++row)
+    {
+      for (size_t col = 0; col < N; ++col)
+      {
+        a.m_[col][row] = m_[row][col];
+      }
+    }
+    return a;
+  }
+
+  /// Return a sub matrix with given row and column removed.
+  /// \param a_row_removed The row to be removed.
+  /// \param a_col_removed The column to be removed.
+  /// \return The submatrix one size smaller.
+  constexpr SquareMatrix<N - 1> sub_matrix(size_t a_row_removed,
+      size_t a_col_removed) const
+  {
+    SquareMatrix<N - 1> a;
+    for (size_t row = 0; row < N - 1; ++row)
+    {
+      for (size_t col = 0; col < N - 1; ++col)
+      {
+        size_t row_from = row >= a_row_removed ? row + 1 : row;
+        size_t col_from = col >= a_col_removed ? col + 1 : col;
+        a(row, col) = m_[row_from][col_from];
+      }
+    }
+    return a;
+  }
+
+  /// Get the determinant of the matrix.
+  /// \return The determinant of the matrix.
+  constexpr Scalar determinant() const
+  {
+    return detail::Determinant<N>::of(*this);
+  }
+
+  /// Return the minor with given row and column removed.
+  /// \param a_row_removed The row to be removed.
+  /// \param a_col_removed The column to be removed.
+  /// \return The minor of the matrix.
+  constexpr Scalar minor(size_t a_row_removed, size_t a_col_removed) const
+  {
+    return sub_matrix(a_row_removed, a_col_removed).determinant();
+  }
+
+  /// Return the cofactor with given row and column removed.
+  /// \param a_row_removed The row to be removed.
+  /// \param a_col_removed The column to be removed.
+  /// \return The cofactor of the matrix.
+  constexpr Scalar cofactor(size_t a_row_removed, size_t a_col_removed) const
+  {
+    Scalar d = minor(a_row_removed, a_col_removed);
+    return ((a_row_removed + a_col_removed) & 1) == 0 ? d : -d;
+  }
+
+  /// Return the inverse of the matrix.
+  /// 4x4 matrices are inverted in closed form, with a faster path for affine
+  /// transformations.
+  /// \return The inverse of the matrix.
+  constexpr SquareMatrix inverse() const
+  {
+    return detail::Inverse<N>::of(*this);
+  }
+
+private:
+  Scalar m_[N][N]; ///< The elements stored row by row.
+};
+
+/// A 4x4 matrix.
+typedef SquareMatrix<4> Matrix4;
+
+/// A 3x3 matrix.
+typedef SquareMatrix<3> Matrix3;
+
+/// A 2x2 matrix.
+typedef SquareMatrix<2> Matrix2;
+
+//------------------------------------------------------------------------------
+constexpr Scalar detail::Determinant<2>::of(const SquareMatrix<2>& a_matrix)
+{
+  return a_matrix(0, 0) * a_matrix(1, 1) - a_matrix(0, 1) * a_matrix(1, 0);
+}
+
+//------------------------------------------------------------------------------
+constexpr Scalar detail::Determinant<1>::of(const SquareMatrix<1>& a_matrix)
+{
+  return a_matrix(0, 0);
+}
+
+/// Determine if a 4x4 matrix is an affine transformation.
+/// \param a_matrix The matrix to check.
+/// \return True if the bottom row is (0, 0, 0, 1).
+constexpr bool is_affine(const Matrix4& a_matrix)
+{
+  return a_matrix(3, 0) == 0 && a_matrix(3, 1) == 0 && a_matrix(3, 2) == 0 &&
+         a_matrix(3, 3) == 1;
+}
+
+/// Invert any 4x4 matrix in closed form.
+/// The 2x2 determinants of the top two and bottom two rows are shared by all
+/// of the cofactors.
+/// \param a_matrix The matrix to invert.
+/// \return The inverse of the matrix.
+constexpr Matrix4 general_inverse(const Matrix4& a_matrix)
+{
+  const Matrix4& a = a_matrix;
+  Scalar s_0 = a(0, 0) * a(1, 1) - a(1, 0) * a(0, 1);
+  Scalar s_1 = a(0, 0) * a(1, 2) - a(1, 0) * a(0, 2);
+  Scalar s_2 = a(0, 0) * a(1, 3) - a(1, 0) * a(0, 3);
+  Scalar s_3 = a(0, 1) * a(1, 2) - a(1, 1) * a(0, 2);
+  Scalar s_4 = a(0, 1) * a(1, 3) - a(1, 1) * a(0, 3);
+  Scalar s_5 = a(0, 2) * a(1, 3) - a(1, 2) * a(0, 3);
+  Scalar c_5 = a(2, 2) * a(3, 3) - a(3, 2) * a(2, 3);
+  Scalar c_4 = a(2, 1) * a(3, 3) - a(3, 1) * a(2, 3);
+  Scalar c_3 = a(2, 1) * a(3, 2) - a(3, 1) * a(2, 2);
+  Scalar c_2 = a(2, 0) * a(3, 3) - a(3, 0) * a(2, 3);
+  Scalar c_1 = a(2, 0) * a(3, 2) - a(3, 0) * a(2, 2);
+  Scalar c_0 = a(2, 0) * a(3, 1) - a(3, 0) * a(2, 1);
+  Scalar det = s_0 * c_5 - s_1 * c_4 + s_2 * c_3 + s_3 * c_2 - s_4 * c_1 +
+               s_5 * c_0;
+
+  // dividing rather than multiplying by 1 / det keeps exact results exact
+  Matrix4 inverse;
+  inverse(0, 0) = (a(1, 1) * c_5 - a(1, 2) * c_4 + a(1, 3) * c_3) / det;
+  inverse(0, 1) = (-a(0, 1) * c_5 + a(0, 2) * c_4 - a(0, 3) * c_3) / det;
+  inverse(0, 2) = (a(3, 1) * s_5 - a(3, 2) * s_4 + a(3, 3) * s_3) / det;
+  inverse(0, 3) = (-a(2, 1) * s_5 + a(2, 2) * s_4 - a(2, 3) * s_3) / det;
+  inverse(1, 0) = (-a(1, 0) * c_5 + a(1, 2) * c_2 - a(1, 3) * c_1) / det;
+  inverse(1, 1) = (a(0, 0) * c_5 - a(0, 2) * c_2 + a(0, 3) * c_1) / det;
+  inverse(1, 2) = (-a(3, 0) * s_5 + a(3, 2) * s_2 - a(3, 3) * s_1) / det;
+  inverse(1, 3) = (a(2, 0) * s_5 - a(2, 2) * s_2 + a(2, 3) * s_1) / det;
+  inverse(2, 0) = (a(1, 0) * c_4 - a(1, 1) * c_2 + a(1, 3) * c_0) / det;
+  inverse(2, 1) = (-a(0, 0) * c_4 + a(0, 1) * c_2 - a(0, 3) * c_0) / det;
+  inverse(2, 2) = (a(3, 0) * s_4 - a(3, 1) * s_2 + a(3, 3) * s_0) / det;
+  inverse(2, 3) = (-a(2, 0) * s_4 + a(2, 1) * s_2 - a(2, 3) * s_0) / det;
+  inverse(3, 0) = (-a(1, 0) * c_3 + a(1, 1) * c_1 - a(1, 2) * c_0) / det;
+  inverse(3, 1) = (a(0, 0) * c_3 - a(0, 1) * c_1 + a(0, 2) * c_0) / det;
+  inverse(3, 2) = (-a(3, 0) * s_3 + a(3, 1) * s_1 - a(3, 2) * s_0) / det;
+  inverse(3, 3) = (a(2, 0) * s_3 - a(2, 1) * s_1 + a(2, 2) * s_0) / det;
+  return inverse;
+}
+
+/// Invert an affine 4x4 transformation.
+/// The upper 3x3 block is inverted on its own and the translation is
+/// transformed by it. Only valid when is_affine() is true.
+/// \param a_matrix The affine matrix to invert.
+/// \return The inverse of the matrix.
+constexpr Matrix4 affine_inverse(const Matrix4& a_matrix)
+{
+  const Matrix4& a = a_matrix;
+  Scalar c_00 = a(1, 1) * a(2, 2) - a(1, 2) * a(2, 1);
+  Scalar c_01 = a(1, 2) * a(2, 0) - a(1, 0) * a(2, 2);
+  Scalar c_02 = a(1, 0) * a(2, 1) - a(1, 1) * a(2, 0);
+  Scalar det = a(0, 0) * c_00 + a(0, 1) * c_01 + a(0, 2) * c_02;
+
+  Matrix4 inverse;
+  inverse(0, 0) = c_00 / det;
+  inverse(0, 1) = (a(0, 2) * a(2, 1) - a(0, 1) * a(2, 2)) / det;
+  inverse(0, 2) = (a(0, 1) * a(1, 2) - a(0, 2) * a(1, 1)) / det;
+  inverse(1, 0) = c_01 / det;
+  inverse(1, 1) = (a(0, 0) * a(2, 2) - a(0, 2) * a(2, 0)) / det;
+  inverse(1, 2) = (a(0, 2) * a(1, 0) - a(0, 0) * a(1, 2)) / det;
+  inverse(2, 0) = c_02 / det;
+  inverse(2, 1) = (a(0, 1) * a(2, 0) - a(0, 0) * a(2, 1)) / det;
+  inverse(2, 2) = (a(0, 0) * a(1, 1) - a(0, 1) * a(1, 0)) / det;
+  for (size_t row = 0; row < 3; ++row)
+  {
+    inverse(row, 3) = -(inverse(row, 0) * a(0, 3) + inverse(row, 1) * a(1, 3) +
+                        inverse(row, 2) * a(2, 3));
+  }
+  inverse(3, 3) = 1;
+  return inverse;
+}
+
+//------------------------------------------------------------------------------
+constexpr Matrix4 detail::Inverse<4>::of(const Matrix4& a_matrix)
+{
+  return is_affine(a_matrix) ? affine_inverse(a_matrix) :
+         general_inverse(a_matrix);
+}
+
+/// Multiply two matrices.
+/// \param a_lhs The first matrix.
+/// \param a_rhs The second matrix.
+/// \return The result of multiplying two matrices.
+template <size_t N>
+constexpr SquareMatrix<N> operator*(const SquareMatrix<N>& a_lhs,
+    const SquareMatrix<N>& a_rhs)
+{
+  SquareMatrix<N> c;
+  for (size_t row = 0; row < N; ++row)
+  {
+    for (size_t col = 0; col < N; ++col)
+    {
+      Scalar sum = 0.0;
+      for (size_t k = 0; k < N; ++k)
+      {
+        sum += a_lhs(row, k) * a_rhs(k, col);
+      }
+      c(row, col) = sum;
+    }
+  }
+  return c;
+}
+
+/// Multiply a 4x4 matrix by a tuple.
+/// \param a_lhs The matrix.
+/// \param a_rhs The tuple.
+/// \return The tuple resulting from the multiplication.
+inline Tuple operator*(const Matrix4& a_lhs, const Tuple& a_rhs)
+{
+  Tuple result;
+  simd::matrix_times4(a_lhs.row(0), a_lhs.row(1), a_lhs.row(2), a_lhs.row(3),
+                      a_rhs.data(), result.data());
+  return result;
+}
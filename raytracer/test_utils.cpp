@@ -15,7 +15,7 @@ bool approximately_equal(double a_lhs, double a_rhs)
 bool nearly_equal(double a_lhs, double a_rhs)
 {
   bool equal;
-  equal = equal_to_digits(a_lhs, a_rhs, 10);
+  equal = equal_to_digits(a_lhs, a_rhs, NEARLY_EQUAL_DIGITS);
   return equal;
 }
 
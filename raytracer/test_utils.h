@@ -1,5 +1,13 @@
 #pragma once
 
+/// Number of digits compared by the nearly_equal() functions.
+/// Single precision only holds about 7 significant digits.
+#if defined(RAYTRACER_FLOAT)
+const int NEARLY_EQUAL_DIGITS = 5;
+#else
+const int NEARLY_EQUAL_DIGITS = 10;
+#endif
+
 /// Determine if two doubles are approximately equal.
 /// \param a_lhs The first double.
 /// \param a_rhs The second double.
@@ -0,0 +1,167 @@
+#include <raytracer/trace.h>
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+
+namespace
+{
+
+/// A span recorded by a thread.
+struct Event
+{
+  const char* name;       ///< The name of the span.
+  std::int64_t start;     ///< Start in nanoseconds since the trace began.
+  std::int64_t duration;  ///< Length in nanoseconds.
+};
+
+/// The spans recorded by one thread.
+struct ThreadBuffer
+{
+  int thread_id = 0;         ///< Number shown for the thread.
+  std::vector<Event> events; ///< Spans in the order they ended.
+};
+
+std::atomic<bool> tracing(false);                   ///< Spans are recorded.
+std::mutex buffers_mutex;                           ///< Guards the buffers.
+std::vector<std::unique_ptr<ThreadBuffer>> buffers; ///< Every buffer.
+std::vector<ThreadBuffer*> free_buffers;            ///< Unused buffers.
+std::atomic<std::int64_t> trace_start(0);           ///< Time zero.
+
+/// The buffer a thread records into. Buffers outlive their threads so the
+/// spans of finished render threads can still be written, and are reused by
+/// later threads so each render does not add more rows to the timeline.
+struct BufferLease
+{
+  ~BufferLease()
+  {
+    if (buffer)
+    {
+      std::lock_guard<std::mutex> lock(buffers_mutex);
+      free_buffers.push_back(buffer);
+    }
+  }
+
+  ThreadBuffer* buffer = nullptr; ///< The buffer, once the thread records.
+};
+
+thread_local BufferLease lease; ///< The buffer of this thread.
+
+//------------------------------------------------------------------------------
+/// Get the time on the steady clock.
+std::int64_t clock_nanoseconds()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//------------------------------------------------------------------------------
+/// Get the time since the trace began.
+std::int64_t now()
+{
+  // time zero is atomic as set_enabled() may move it while spans are timed
+  return clock_nanoseconds() - trace_start.load(std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+/// Get the buffer of the calling thread, registering it on first use.
+ThreadBuffer& buffer()
+{
+  if (!lease.buffer)
+  {
+    std::lock_guard<std::mutex> lock(buffers_mutex);
+    if (free_buffers.empty())
+    {
+      buffers.push_back(std::make_unique<ThreadBuffer>());
+      buffers.back()->thread_id = static_cast<int>(buffers.size());
+      lease.buffer = buffers.back().get();
+    }
+    else
+    {
+      lease.buffer = free_buffers.back();
+      free_buffers.pop_back();
+    }
+  }
+  return *lease.buffer;
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------
+bool trace::enabled()
+{
+  return tracing.load(std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+void trace::set_enabled(bool a_enabled)
+{
+  if (a_enabled && span_count() == 0)
+    trace_start.store(clock_nanoseconds(), std::memory_order_relaxed);
+  tracing.store(a_enabled);
+}
+
+//------------------------------------------------------------------------------
+void trace::clear()
+{
+  std::lock_guard<std::mutex> lock(buffers_mutex);
+  for (auto& thread : buffers)
+    thread->events.clear();
+}
+
+//------------------------------------------------------------------------------
+int trace::span_count()
+{
+  std::lock_guard<std::mutex> lock(buffers_mutex);
+  size_t count = 0;
+  for (const auto& thread : buffers)
+    count += thread->events.size();
+  return static_cast<int>(count);
+}
+
+//------------------------------------------------------------------------------
+void trace::write_json(std::ostream& a_output)
+{
+  std::lock_guard<std::mutex> lock(buffers_mutex);
+  // times are written in microseconds to the nanosecond, as the default six
+  // significant digits lose resolution a second into the trace
+  std::ios::fmtflags flags = a_output.flags();
+  std::streamsize precision = a_output.precision();
+  a_output << std::fixed << std::setprecision(3);
+  a_output << "{\"traceEvents\": [";
+  bool first = true;
+  for (const auto& thread : buffers)
+  {
+    for (const Event& event : thread->events)
+    {
+      a_output << (first ? "\n" : ",\n");
+      a_output << "  {\"name\": \"" << event.name << "\", \"ph\": \"X\""
+               << ", \"ts\": " << event.start / 1000.0
+               << ", \"dur\": " << event.duration / 1000.0
+               << ", \"pid\": 1, \"tid\": " << thread->thread_id << "}";
+      first = false;
+    }
+  }
+  a_output << "\n], \"displayTimeUnit\": \"ms\"}\n";
+  a_output.flags(flags);
+  a_output.precision(precision);
+}
+
+//------------------------------------------------------------------------------
+trace::Span::Span(const char* a_name)
+    : name_(enabled() ? a_name : nullptr)
+      , start_(name_ ? now() : 0)
+{
+}
+
+//------------------------------------------------------------------------------
+trace::Span::~Span()
+{
+  if (name_)
+    buffer().events.push_back(Event{name_, start_, now() - start_});
+}
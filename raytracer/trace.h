@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+
+
+/// Timeline of the work done by each thread, written in the Chrome
+/// trace_event JSON format for viewing in chrome://tracing or Perfetto.
+///
+/// Spans are recorded into a buffer owned by the recording thread, so
+/// recording takes no lock. A thread takes a lock once, to register its
+/// buffer, the first time it records. While tracing is off a span only
+/// reads an atomic flag.
+namespace trace
+{
+
+/// Determine if spans are being recorded.
+/// \return True if tracing is on.
+bool enabled();
+
+/// Turn the recording of spans on or off. Turning tracing on starts the
+/// timeline at zero when nothing has been recorded yet. Turn tracing on
+/// before starting the threads to trace, as a span that other threads
+/// start at the same moment may be timed from the previous zero.
+/// \param a_enabled True to record spans.
+void set_enabled(bool a_enabled);
+
+/// Remove every recorded span. Call when no thread is recording.
+void clear();
+
+/// Get the number of spans recorded by all threads.
+/// Call when no thread is recording.
+/// \return The number of spans.
+int span_count();
+
+/// Write the recorded spans as a Chrome trace_event JSON document.
+/// Call when no thread is recording.
+/// \param a_output The stream to write to.
+void write_json(std::ostream& a_output);
+
+/// Records the time from construction to destruction as a span of the
+/// calling thread, if tracing was on when it was constructed.
+class Span
+{
+public:
+  /// Start a span.
+  /// \param a_name The name shown for the span. Must outlive the trace,
+  /// such as a string literal.
+  explicit Span(const char* a_name);
+
+  ~Span();
+
+  Span(const Span&) = delete;
+  Span& operator=(const Span&) = delete;
+
+private:
+  const char* name_;    ///< The name of the span, or nullptr if not traced.
+  std::int64_t start_;  ///< Start of the span in nanoseconds.
+};
+
+} // namespace trace
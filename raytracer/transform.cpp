@@ -4,8 +4,8 @@
 
 
 //------------------------------------------------------------------------------
-Matrix translation(double a_x_translation, double a_y_translation,
-    double a_z_translation)
+Matrix translation(Scalar a_x_translation, Scalar a_y_translation,
+    Scalar a_z_translation)
 {
   Matrix t = Matrix::identity_matrix(4);
   t[0][3] = a_x_translation;
@@ -15,7 +15,7 @@ Matrix translation(double a_x_translation, double a_y_translation,
 }
 
 //------------------------------------------------------------------------------
-Matrix scaling(double a_x_scale, double a_y_scale, double a_z_scale)
+Matrix scaling(Scalar a_x_scale, Scalar a_y_scale, Scalar a_z_scale)
 {
   Matrix t;
   t[0][0] = a_x_scale;
@@ -26,11 +26,11 @@ Matrix scaling(double a_x_scale, double a_y_scale, double a_z_scale)
 }
 
 //------------------------------------------------------------------------------
-Matrix rotation_x(double a_radians)
+Matrix rotation_x(Scalar a_radians)
 {
   Matrix t;
-  double cos_r = cos(a_radians);
-  double sin_r = sin(a_radians);
+  Scalar cos_r = std::cos(a_radians);
+  Scalar sin_r = std::sin(a_radians);
   t[0][0] = 1.0;
   t[1][1] = cos_r;
   t[2][2] = cos_r;
@@ -41,11 +41,11 @@ Matrix rotation_x(double a_radians)
 }
 
 //------------------------------------------------------------------------------
-Matrix rotation_y(double a_radians)
+Matrix rotation_y(Scalar a_radians)
 {
   Matrix t;
-  double cos_r = cos(a_radians);
-  double sin_r = sin(a_radians);
+  Scalar cos_r = std::cos(a_radians);
+  Scalar sin_r = std::sin(a_radians);
   t[0][0] = cos_r;
   t[0][2] = sin_r;
   t[2][0] = -sin_r;
@@ -56,11 +56,11 @@ Matrix rotation_y(double a_radians)
 }
 
 //------------------------------------------------------------------------------
-Matrix rotation_z(double a_radians)
+Matrix rotation_z(Scalar a_radians)
 {
   Matrix t;
-  double cos_r = cos(a_radians);
-  double sin_r = sin(a_radians);
+  Scalar cos_r = std::cos(a_radians);
+  Scalar sin_r = std::sin(a_radians);
   t[0][0] = cos_r;
   t[1][1] = cos_r;
   t[1][0] = sin_r;
@@ -71,8 +71,8 @@ Matrix rotation_z(double a_radians)
 }
 
 //------------------------------------------------------------------------------
-Matrix shearing(double a_xy, double a_xz, double a_yx, double a_yz, double a_zx,
-    double a_zy)
+Matrix shearing(Scalar a_xy, Scalar a_xz, Scalar a_yx, Scalar a_yz, Scalar a_zx,
+    Scalar a_zy)
 {
   Matrix t = Matrix::identity_matrix(4);
   t[0][1] = a_xy;
@@ -2,6 +2,8 @@
 
 #include <cmath>
 
+#include <raytracer/scalar.h>
+
 
 class Matrix;
 
@@ -12,30 +14,30 @@ class Tuple;
 /// \param a_y_translation The offset to translate y coordinate.
 /// \param a_z_translation The offset to translate z coordinate.
 /// \return The translation transformation matrix.
-Matrix translation(double a_x_translation, double a_y_translation,
-    double a_z_translation);
+Matrix translation(Scalar a_x_translation, Scalar a_y_translation,
+    Scalar a_z_translation);
 
 /// Build transformation matrix for scaling.
 /// \param a_x_scale The factor to scale x coordinate.
 /// \param a_y_scale The factor to scale y coordinate.
 /// \param a_z_scale The factor to scale z coordinate.
 /// \return The scaling transformation matrix.
-Matrix scaling(double a_x_scale, double a_y_scale, double a_z_scale);
+Matrix scaling(Scalar a_x_scale, Scalar a_y_scale, Scalar a_z_scale);
 
 /// Build transformation matrix for rotation about the x-axis.
 /// \param a_radians The amount to rotate in radians.
 /// \return The rotation transformation matrix.
-Matrix rotation_x(double a_radians);
+Matrix rotation_x(Scalar a_radians);
 
 /// Build transformation matrix for rotation about the y-axis.
 /// \param a_radians The amount to rotate in radians.
 /// \return The rotation transformation matrix.
-Matrix rotation_y(double a_radians);
+Matrix rotation_y(Scalar a_radians);
 
 /// Build transformation matrix for rotation about the z-axis.
 /// \param a_radians The amount to rotate in radians.
 /// \return The rotation transformation matrix.
-Matrix rotation_z(double a_radians);
+Matrix rotation_z(Scalar a_radians);
 
 /// Build transformation matrix for shearing.
 /// \param a_xy Shear of x in proportion to y.
@@ -45,8 +47,8 @@ Matrix rotation_z(double a_radians);
 /// \param a_zx Shear of z in proportion to x.
 /// \param a_zy Shear of z in proportion to y.
 /// \return The shearing transformation matrix.
-Matrix shearing(double a_xy, double a_xz, double a_yx, double a_yz, double a_zx,
-    double a_zy);
+Matrix shearing(Scalar a_xy, Scalar a_xz, Scalar a_yx, Scalar a_yz, Scalar a_zx,
+    Scalar a_zy);
 
 /// Build view transformation matrix.
 /// \param a_look_from The point looked from (where the eye is located).
@@ -1,14 +1,14 @@
 #pragma once
 
-/// A tuple of 4 doubles (x, y, z, w).
+#include <raytracer/scalar.h>
+#include <raytracer/simd.h>
+
+/// A tuple of 4 scalars (x, y, z, w).
 struct Tuple
 {
   /// Constructs tuple with coordinate values of 0.0.
   Tuple()
-      : x_()
-        , y_()
-        , z_()
-        , w_()
+      : v_()
   {
   }
 
@@ -17,38 +17,45 @@ struct Tuple
   /// \param a_y The Y value.
   /// \param a_z The Z value.
   /// \param a_w The W value.
-  Tuple(double a_x, double a_y, double a_z, double a_w)
-      : x_(a_x)
-        , y_(a_y)
-        , z_(a_z)
-        , w_(a_w)
+  Tuple(Scalar a_x, Scalar a_y, Scalar a_z, Scalar a_w)
+      : v_{a_x, a_y, a_z, a_w}
   {
   }
 
   /// Get the X value.
   /// \return The X value.
-  double x() const
-  { return x_; }
+  Scalar x() const
+  { return v_[0]; }
 
   /// Get the Y value.
   /// \return The Y value.
-  double y() const
-  { return y_; }
+  Scalar y() const
+  { return v_[1]; }
 
   /// Get the Z value.
   /// \return The Z value.
-  double z() const
-  { return z_; }
+  Scalar z() const
+  { return v_[2]; }
 
   /// Get the W value.
   /// \return The W value.
-  double w() const
-  { return w_; }
+  Scalar w() const
+  { return v_[3]; }
 
   /// Set the W value.
   /// \param a_w The W value.
-  void set_w(double a_w)
-  { w_ = a_w; }
+  void set_w(Scalar a_w)
+  { v_[3] = a_w; }
+
+  /// Get the values as an array.
+  /// \return Pointer to the X, Y, Z and W values in that order.
+  const Scalar* data() const
+  { return v_; }
+
+  /// Get the values as an array.
+  /// \return Pointer to the X, Y, Z and W values in that order.
+  Scalar* data()
+  { return v_; }
 
   /// Equals operator.
   /// \param a_rhs The Tuple to check for equality.
@@ -74,22 +81,23 @@ struct Tuple
 
   /// Calculate the magnitude (length).
   /// \return The magnitude or length of a vector tuple.
-  double magnitude() const;
+  Scalar magnitude() const;
 
-  double x_; ///< The X coordinate.
-  double y_; ///< The Y coordinate.
-  double z_; ///< The Z coordinate.
-  double w_; ///< The W coordinate.
+  Scalar v_[4]; ///< The X, Y, Z and W coordinates.
 };
 
+static_assert(sizeof(Tuple) == 4 * sizeof(Scalar),
+              "Tuple values must be packed for the simd kernels");
+
 /// Adds two tuples.
 /// \param a_lhs The first operand.
 /// \param a_rhs The second operand.
 /// \return The result of adding the two tuples.
 inline Tuple operator+(const Tuple& a_lhs, const Tuple& a_rhs)
 {
-  return {a_lhs.x_ + a_rhs.x_, a_lhs.y_ + a_rhs.y_, a_lhs.z_ + a_rhs.z_,
-          a_lhs.w_ + a_rhs.w_};
+  Tuple result;
+  simd::add4(a_lhs.data(), a_rhs.data(), result.data());
+  return result;
 }
 
 /// Subtracts one tuple from another.
@@ -98,28 +106,31 @@ inline Tuple operator+(const Tuple& a_lhs, const Tuple& a_rhs)
 /// \return The result of subtracting the two tuples.
 inline Tuple operator-(const Tuple& a_lhs, const Tuple& a_rhs)
 {
-  return {a_lhs.x_ - a_rhs.x_, a_lhs.y_ - a_rhs.y_, a_lhs.z_ - a_rhs.z_,
-          a_lhs.w_ - a_rhs.w_};
+  Tuple result;
+  simd::sub4(a_lhs.data(), a_rhs.data(), result.data());
+  return result;
 }
 
 /// Multiplies a tuple by a scalar.
 /// \param a_lhs The tuple operand.
 /// \param a_rhs The scalar operand.
 /// \return The result of multiplying a tuple by a scalar.
-inline Tuple operator*(const Tuple& a_lhs, double a_rhs)
+inline Tuple operator*(const Tuple& a_lhs, Scalar a_rhs)
 {
-  return {a_lhs.x_ * a_rhs, a_lhs.y_ * a_rhs, a_lhs.z_ * a_rhs,
-          a_lhs.w_ * a_rhs};
+  Tuple result;
+  simd::scale4(a_lhs.data(), a_rhs, result.data());
+  return result;
 }
 
 /// Divides a tuple by a scalar.
 /// \param a_lhs The tuple operand.
 /// \param a_rhs The scalar operand.
 /// \return The result of multiplying a tuple by a scalar.
-inline Tuple operator/(const Tuple& a_lhs, double a_rhs)
+inline Tuple operator/(const Tuple& a_lhs, Scalar a_rhs)
 {
-  return {a_lhs.x_ / a_rhs, a_lhs.y_ / a_rhs, a_lhs.z_ / a_rhs,
-          a_lhs.w_ / a_rhs};
+  Tuple result;
+  simd::divide4(a_lhs.data(), a_rhs, result.data());
+  return result;
 }
 
 /// Negates a tuple.
@@ -127,14 +138,14 @@ inline Tuple operator/(const Tuple& a_lhs, double a_rhs)
 /// \return The negated tuple.
 inline Tuple operator-(const Tuple& a_rhs)
 {
-  return {-a_rhs.x_, -a_rhs.y_, -a_rhs.z_, -a_rhs.w_};
+  return {-a_rhs.x(), -a_rhs.y(), -a_rhs.z(), -a_rhs.w()};
 }
 
 /// Construct a point tuple.
 /// \param a_x The X value.
 /// \param a_y The Y value.
 /// \param a_z The Z value.
-inline Tuple point(double a_x, double a_y, double a_z)
+inline Tuple point(Scalar a_x, Scalar a_y, Scalar a_z)
 {
   Tuple p(a_x, a_y, a_z, 1.0);
   return p;
@@ -144,7 +155,7 @@ inline Tuple point(double a_x, double a_y, double a_z)
 /// \param a_x The X value.
 /// \param a_y The Y value.
 /// \param a_z The Z value.
-inline Tuple vector(double a_x, double a_y, double a_z)
+inline Tuple vector(Scalar a_x, Scalar a_y, Scalar a_z)
 {
   Tuple v(a_x, a_y, a_z, 0.0);
   return v;
@@ -154,13 +165,21 @@ inline Tuple vector(double a_x, double a_y, double a_z)
 /// \param a_lhs The tuple operand.
 /// \param a_rhs The scalar operand.
 /// \return The dot product of the two vectors.
-double dot(const Tuple& a_lhs, const Tuple& a_rhs);
+inline Scalar dot(const Tuple& a_lhs, const Tuple& a_rhs)
+{
+  return simd::dot4(a_lhs.data(), a_rhs.data());
+}
 
 /// Calculate the cross product of two vector tuples.
 /// \param a_lhs The tuple operand.
 /// \param a_rhs The scalar operand.
 /// \return The cross product of the two vectors.
-Tuple cross(const Tuple& a_lhs, const Tuple& a_rhs);
+inline Tuple cross(const Tuple& a_lhs, const Tuple& a_rhs)
+{
+  Tuple result;
+  simd::cross4(a_lhs.data(), a_rhs.data(), result.data());
+  return result;
+}
 
 /// Calculate the reflection of an incoming vector off of a surface.
 /// \param a_in_vector The incoming vector to reflect off of surface.
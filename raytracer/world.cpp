@@ -1,9 +1,13 @@
 #include <raytracer/world.h>
 
 #include <algorithm>
+#include <limits>
+
 #include <raytracer/intersection.h>
 #include <raytracer/material.h>
+#include <raytracer/render_stats.h>
 #include <raytracer/sphere.h>
+#include <raytracer/trace.h>
 #include <raytracer/transform.h>
 
 
@@ -19,70 +23,406 @@ Sphere& World::object(int a_object_index)
   return *objects_.at(a_object_index);
 }
 
+//------------------------------------------------------------------------------
+const Sphere& World::object(int a_object_index) const
+{
+  return *objects_.at(a_object_index);
+}
+
+//------------------------------------------------------------------------------
+void World::set_object_transform(int a_object_index,
+    const Matrix& a_transform)
+{
+  objects_.at(a_object_index)->set_transform(a_transform);
+  store_.set(a_object_index, *objects_[a_object_index]);
+  bvh_.clear();
+}
+
 //------------------------------------------------------------------------------
 void World::add_object(std::unique_ptr<Sphere> a_object)
 {
   objects_.push_back(std::move(a_object));
+  store_.add(*objects_.back());
+  bvh_.clear();
+}
+
+//------------------------------------------------------------------------------
+void World::add_object(std::unique_ptr<Plane> a_plane)
+{
+  planes_.push_back(std::move(a_plane));
+}
+
+//------------------------------------------------------------------------------
+void World::reserve_objects(int a_object_count)
+{
+  objects_.reserve(static_cast<size_t>(a_object_count));
+  store_.reserve(a_object_count);
+}
+
+//------------------------------------------------------------------------------
+void World::set_objects(std::vector<std::unique_ptr<Sphere>> a_objects,
+    SphereStore a_store, Bvh a_bvh)
+{
+  objects_ = std::move(a_objects);
+  store_ = std::move(a_store);
+  bvh_ = std::move(a_bvh);
+}
+
+//------------------------------------------------------------------------------
+void World::build_bvh()
+{
+  trace::Span span("build bvh");
+  bvh_.build(store_.bounds());
 }
 
 //------------------------------------------------------------------------------
 void World::set_light(std::unique_ptr<::Light> a_light)
 {
-  light_ = std::move(a_light);
+  lights_.clear();
+  if (a_light)
+    lights_.push_back(*a_light);
+}
+
+//------------------------------------------------------------------------------
+void World::add_light(const ::Light& a_light)
+{
+  lights_.push_back(a_light);
 }
 
 //------------------------------------------------------------------------------
 std::vector<Intersection> World::intersect(const Ray& a_ray) const
 {
   std::vector<Intersection> intersections;
-  std::vector<Intersection> object_intersections;
-  for (const auto& object : objects_)
+  intersect(a_ray, intersections);
+  return intersections;
+}
+
+//------------------------------------------------------------------------------
+void World::intersect(const Ray& a_ray,
+    std::vector<Intersection>& a_intersections) const
+{
+  a_intersections.clear();
+  for (const auto& plane : planes_)
+    plane->intersect(a_ray, a_intersections);
+  if (bvh_.empty())
   {
-    object_intersections = object->intersect(a_ray);
-    intersections.insert(intersections.end(), object_intersections.begin(),
-                         object_intersections.end());
+    for (const auto& object : objects_)
+      object->intersect(a_ray, a_intersections);
   }
-  std::sort(intersections.begin(), intersections.end(),
+  else
+  {
+    // every intersection is wanted, including those behind the ray origin
+    const Scalar infinity = std::numeric_limits<Scalar>::infinity();
+    bvh_.traverse(a_ray, -infinity, infinity, [&](int a_object)
+    {
+      objects_[a_object]->intersect(a_ray, a_intersections);
+      return true;
+    });
+  }
+  std::sort(a_intersections.begin(), a_intersections.end(),
             [](const Intersection& a_lhs, const Intersection& a_rhs)
             { return a_lhs.t() < a_rhs.t(); });
-  return intersections;
 }
 
 //------------------------------------------------------------------------------
-Color World::shade_hit(const Computations& a_computations) const
+bool World::object_distances(int a_object, const Ray& a_ray, Scalar& a_t_1,
+    Scalar& a_t_2) const
+{
+  return store_.intersect_distances(a_object, a_ray, a_t_1, a_t_2);
+}
+
+//------------------------------------------------------------------------------
+template <int N>
+void World::object_packet_hits(int a_object, const RayPacket<N>& a_packet,
+    RayPacketHits<N>& a_hits) const
+{
+  store_.intersect_packet(a_object, a_packet, a_hits);
+}
+
+//------------------------------------------------------------------------------
+const Plane* World::nearest_plane(const Ray& a_ray, Scalar& a_t_max) const
+{
+  const Plane* nearest = nullptr;
+  for (const auto& plane : planes_)
+  {
+    Scalar t;
+    if (plane->intersect_distance(a_ray, t) && t > 0 && t < a_t_max)
+    {
+      a_t_max = t;
+      nearest = plane.get();
+    }
+  }
+  return nearest;
+}
+
+//------------------------------------------------------------------------------
+bool World::plane_blocks(const Ray& a_ray, Scalar a_t_max) const
+{
+  for (const auto& plane : planes_)
+  {
+    Scalar t;
+    if (plane->intersect_distance(a_ray, t) && t > 0 && t < a_t_max)
+      return true;
+  }
+  return false;
+}
+
+//------------------------------------------------------------------------------
+const Shape* World::closest_hit(const Ray& a_ray, Scalar& a_t) const
+{
+  // planes first, so a near floor or wall narrows the sphere search
+  Scalar t_max = std::numeric_limits<Scalar>::infinity();
+  const Shape* closest = nearest_plane(a_ray, t_max);
+  auto test_object = [&](int a_object)
+  {
+    Scalar t_1;
+    Scalar t_2;
+    if (object_distances(a_object, a_ray, t_1, t_2))
+    {
+      Scalar t = t_1 > 0 ? t_1 : t_2;
+      if (t > 0 && t < t_max)
+      {
+        t_max = t;
+        closest = objects_[a_object].get();
+      }
+    }
+    return true;
+  };
+
+  if (bvh_.empty())
+  {
+    for (int i = 0; i < object_count(); ++i)
+      test_object(i);
+  }
+  else
+  {
+    bvh_.traverse(a_ray, 0, t_max, test_object);
+  }
+  a_t = t_max;
+  return closest;
+}
+
+//------------------------------------------------------------------------------
+template <int N>
+void World::closest_hits(const RayPacket<N>& a_packet,
+    const Shape** a_objects, Scalar* a_t) const
+{
+  for (int lane = 0; lane < N; ++lane)
+  {
+    a_objects[lane] = nullptr;
+    a_t[lane] = std::numeric_limits<Scalar>::infinity();
+  }
+  if (!planes_.empty())
+  {
+    for (int lane = 0; lane < a_packet.count; ++lane)
+      a_objects[lane] = nearest_plane(a_packet.ray(lane), a_t[lane]);
+  }
+
+  RayPacketHits<N> hits;
+  auto test_object = [&](int a_object)
+  {
+    object_packet_hits(a_object, a_packet, hits);
+    for (int lane = 0; lane < a_packet.count; ++lane)
+    {
+      if (!hits.hit[lane])
+        continue;
+      Scalar t = hits.t_1[lane] > 0 ? hits.t_1[lane] : hits.t_2[lane];
+      if (t > 0 && t < a_t[lane])
+      {
+        a_t[lane] = t;
+        a_objects[lane] = objects_[a_object].get();
+      }
+    }
+  };
+
+  if (bvh_.empty())
+  {
+    for (int i = 0; i < object_count(); ++i)
+      test_object(i);
+  }
+  else
+  {
+    bvh_.traverse_packet(a_packet, a_t, test_object);
+  }
+}
+
+template void World::closest_hits(const RayPacket<4>&, const Shape**,
+    Scalar*) const;
+template void World::closest_hits(const RayPacket<8>&, const Shape**,
+    Scalar*) const;
+template void World::closest_hits(const RayPacket<16>&, const Shape**,
+    Scalar*) const;
+
+//------------------------------------------------------------------------------
+bool World::any_hit(const Ray& a_ray, Scalar a_t_max) const
+{
+  return plane_blocks(a_ray, a_t_max) || first_blocker(a_ray, a_t_max) >= 0;
+}
+
+//------------------------------------------------------------------------------
+bool World::blocks(int a_object, const Ray& a_ray, Scalar a_t_max) const
+{
+  Scalar t_1;
+  Scalar t_2;
+  if (!object_distances(a_object, a_ray, t_1, t_2))
+    return false;
+  Scalar t = t_1 > 0 ? t_1 : t_2;
+  return t > 0 && t < a_t_max;
+}
+
+//------------------------------------------------------------------------------
+int World::first_blocker(const Ray& a_ray, Scalar a_t_max) const
+{
+  int found = -1;
+  auto test_object = [&](int a_object)
+  {
+    if (blocks(a_object, a_ray, a_t_max))
+      found = a_object;
+    return found < 0;
+  };
+
+  if (bvh_.empty())
+  {
+    for (int i = 0; i < object_count() && found < 0; ++i)
+      test_object(i);
+  }
+  else
+  {
+    bvh_.traverse(a_ray, 0, a_t_max, test_object);
+  }
+  return found;
+}
+
+//------------------------------------------------------------------------------
+Color World::shade_hit(const Computations& a_computations,
+    ShadowCache* a_shadow_cache) const
 {
-  bool shadowed = is_shadowed(a_computations.over_point);
-  return lighting(a_computations.object->material(), *light_,
-                  a_computations.point, a_computations.to_eye,
-                  a_computations.normal, shadowed);
+  const int batch_size = 8;
+  const Material& material = a_computations.object->material();
+  Color color;
+  for (int first = 0; first < light_count(); first += batch_size)
+  {
+    int batch_end = std::min(first + batch_size, light_count());
+
+    // gather a shadow ray for each light that can reach the surface; -1
+    // marks lights behind the surface, -2 lights too dim to shade
+    Tuple directions[batch_size];
+    Scalar distances[batch_size];
+    int lanes[batch_size];
+    int ray_count = 0;
+    for (int i = first; i < batch_end; ++i)
+    {
+      const ::Light& light = lights_[i];
+      const Color& intensity = light.intensity();
+      Scalar brightest = std::max(intensity.red(),
+                                  std::max(intensity.green(), intensity.blue()));
+      if (brightest <= light_threshold_)
+      {
+        lanes[i - first] = -2;
+        continue;
+      }
+
+      Tuple to_light = (light.position() - a_computations.point).normalize();
+      if (dot(to_light, a_computations.normal) < 0)
+      {
+        lanes[i - first] = -1;
+        continue;
+      }
+
+      Tuple to_shadow_light = light.position() - a_computations.over_point;
+      lanes[i - first] = ray_count;
+      distances[ray_count] = to_shadow_light.magnitude();
+      directions[ray_count++] = to_shadow_light.normalize();
+    }
+
+    // the rays spread out towards the lights, so each stops at its own
+    // first blocker rather than being traversed together as a packet
+    bool shadowed[batch_size];
+    for (int lane = 0; lane < ray_count; ++lane)
+      shadowed[lane] = occluded(Ray(a_computations.over_point, directions[lane]),
+                                distances[lane], a_shadow_cache);
+
+    for (int i = first; i < batch_end; ++i)
+    {
+      int lane = lanes[i - first];
+      if (lane == -2)
+        continue;
+      // a light behind the surface only adds ambient, as in shadow
+      bool in_shadow = lane < 0 || shadowed[lane];
+      color = color + lighting(material, lights_[i], a_computations.point,
+                               a_computations.to_eye, a_computations.normal,
+                               in_shadow);
+    }
+  }
+  return color;
 }
 
 //------------------------------------------------------------------------------
-Color World::color_at(const Ray& a_ray) const
+Color World::color_at(const Ray& a_ray, ShadowCache* a_shadow_cache) const
+{
+  Scalar t;
+  const Shape* object = closest_hit(a_ray, t);
+  return color_for_hit(a_ray, object, t, a_shadow_cache);
+}
+
+//------------------------------------------------------------------------------
+Color World::color_for_hit(const Ray& a_ray, const Shape* a_object,
+    Scalar a_t, ShadowCache* a_shadow_cache) const
 {
-  std::vector<Intersection> intersections = intersect(a_ray);
-  const Intersection* intersection = hit(intersections);
   Color color;
-  if (intersection)
+  if (a_object)
   {
-    Computations computations = intersection->prepare_computations(a_ray);
-    color = shade_hit(computations);
+    Computations computations =
+        Intersection(a_t, *a_object).prepare_computations(a_ray);
+    color = shade_hit(computations, a_shadow_cache);
   }
 
   return color;
 }
 
-bool World::is_shadowed(const Tuple& a_point) const
+//------------------------------------------------------------------------------
+bool World::is_shadowed(const Tuple& a_point,
+    ShadowCache* a_shadow_cache) const
+{
+  if (lights_.empty())
+    return false;
+  return is_shadowed(a_point, lights_.front(), a_shadow_cache);
+}
+
+//------------------------------------------------------------------------------
+bool World::is_shadowed(const Tuple& a_point, const ::Light& a_light,
+    ShadowCache* a_shadow_cache) const
 {
-  Tuple to_light = light_->position() - a_point;
-  double distance = to_light.magnitude();
+  Tuple to_light = a_light.position() - a_point;
+  Scalar distance = to_light.magnitude();
   Tuple direction = to_light.normalize();
-  Ray ray(a_point, direction);
-  Intersections intersections = intersect(ray);
-  const Intersection* intersection = hit(intersections);
-  if (intersection && intersection->t() < distance)
+  return occluded(Ray(a_point, direction), distance, a_shadow_cache);
+}
+
+//------------------------------------------------------------------------------
+bool World::occluded(const Ray& a_ray, Scalar a_t_max,
+    ShadowCache* a_shadow_cache) const
+{
+  stats::count(&RenderStats::shadow_rays);
+  if (!a_shadow_cache)
+    return any_hit(a_ray, a_t_max);
+
+  // neighbouring points are usually blocked by the same object
+  ShadowCache& cache = *a_shadow_cache;
+  ++cache.stats.lookups;
+  int last = cache.last_occluder;
+  if (last >= 0 && last < object_count() && blocks(last, a_ray, a_t_max))
+  {
+    ++cache.stats.hits;
     return true;
-  return false;
+  }
+  if (plane_blocks(a_ray, a_t_max))
+    return true;
+
+  int blocker = first_blocker(a_ray, a_t_max);
+  if (blocker >= 0)
+    cache.last_occluder = blocker;
+  return blocker >= 0;
 }
 
 //------------------------------------------------------------------------------
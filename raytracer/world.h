@@ -3,8 +3,13 @@
 #include <memory>
 #include <vector>
 
+#include <raytracer/bvh.h>
 #include <raytracer/intersection.h>
 #include <raytracer/light.h>
+#include <raytracer/plane.h>
+#include <raytracer/ray_packet.h>
+#include <raytracer/sphere.h>
+#include <raytracer/sphere_store.h>
 
 
 class Computations;
@@ -15,52 +20,272 @@ class Light;
 
 class Ray;
 
+class Shape;
+
 class Sphere;
 
+/// Counts of shadow rays answered by a ShadowCache.
+struct ShadowCacheStats
+{
+  long lookups = 0; ///< Shadow rays cast with the cache.
+  long hits = 0;    ///< Shadow rays blocked by the remembered object.
+
+  /// Get the fraction of shadow rays answered by the remembered object.
+  /// \return The hit rate from 0.0 to 1.0 (0.0 if nothing was cast).
+  double hit_rate() const
+  {
+    return lookups > 0 ? static_cast<double>(hits) / lookups : 0.0;
+  }
+
+  /// Add the counts of another cache.
+  /// \param a_rhs The counts to add.
+  void merge(const ShadowCacheStats& a_rhs)
+  {
+    lookups += a_rhs.lookups;
+    hits += a_rhs.hits;
+  }
+};
+
+/// Remembers the object that last blocked a shadow ray so that the next
+/// shadow ray, usually from a neighbouring pixel, tests it first.
+/// Not thread safe: each render thread needs its own cache.
+struct ShadowCache
+{
+  int last_occluder = -1; ///< Index of the last blocking object (or -1).
+  ShadowCacheStats stats; ///< Hit counts.
+};
+
 /// World for a ray traced scene.
+///
+/// Objects are kept in a list per type so that each type is intersected
+/// through its own non-virtual functions. Spheres are bounded and may be
+/// put in a bounding volume hierarchy; planes are infinite and are tested
+/// against every ray.
 class World
 {
 public:
-  /// Get the number of objects in the World.
-  /// \return The number of objects.
+  /// Get the number of spheres in the World.
+  /// \return The number of spheres.
   int object_count() const;
 
-  /// Get object of given index in world.
+  /// Get object of given index in world to change it.
+  /// Change its transform with set_object_transform() rather than through
+  /// the object, so that the world updates the data rays are tested against.
   /// \param a_object_index The index of the object to get.
   /// \return The object at the given index.
   Sphere& object(int a_object_index);
 
+  /// Get object of given index in world.
+  /// \param a_object_index The index of the object to get.
+  /// \return The object at the given index.
+  const Sphere& object(int a_object_index) const;
+
+  /// Set the transform of an object of the world.
+  /// Removes the bounding volume hierarchy if one has been built, so build
+  /// it again once the objects are changed.
+  /// \param a_object_index The index of the object to change.
+  /// \param a_transform The new transformation matrix of the object.
+  void set_object_transform(int a_object_index, const Matrix& a_transform);
+
   /// Add an object to the world.
+  /// Removes the bounding volume hierarchy if one has been built.
   /// \param a_object The object to add to the world.
   void add_object(std::unique_ptr<Sphere> a_object);
 
-  /// Set the world light.
-  /// \param a_light The light to add to the world.
+  /// Add a plane to the world.
+  /// \param a_plane The plane to add to the world.
+  void add_object(std::unique_ptr<Plane> a_plane);
+
+  /// Get the number of planes in the World.
+  /// \return The number of planes.
+  int plane_count() const
+  {
+    return static_cast<int>(planes_.size());
+  }
+
+  /// Get plane of given index in world.
+  /// \param a_plane_index The index of the plane to get.
+  /// \return The plane at the given index.
+  Plane& plane(int a_plane_index)
+  {
+    return *planes_.at(a_plane_index);
+  }
+
+  /// Get plane of given index in world.
+  /// \param a_plane_index The index of the plane to get.
+  /// \return The plane at the given index.
+  const Plane& plane(int a_plane_index) const
+  {
+    return *planes_.at(a_plane_index);
+  }
+
+  /// Reserve room for a number of objects so that adding them does not
+  /// reallocate.
+  /// \param a_object_count The number of objects.
+  void reserve_objects(int a_object_count);
+
+  /// Replace the objects with ones whose sphere store and bounding volume
+  /// hierarchy were built earlier, such as by a scene cache, so that
+  /// neither is rebuilt. Both must cover the same objects in the same order.
+  /// \param a_objects The objects of the world.
+  /// \param a_store The intersection data of the objects.
+  /// \param a_bvh The hierarchy over the objects (may be empty).
+  void set_objects(std::vector<std::unique_ptr<Sphere>> a_objects,
+      SphereStore a_store, Bvh a_bvh);
+
+  /// Build a bounding volume hierarchy over the objects so that rays only
+  /// test the objects they may hit. Adding an object or changing an object
+  /// transform removes the hierarchy, so build it again afterwards.
+  void build_bvh();
+
+  /// Get the bounding volume hierarchy.
+  /// \return The hierarchy (empty if not built).
+  const Bvh& bvh() const
+  {
+    return bvh_;
+  }
+
+  /// Set the world light, replacing any lights already in the world.
+  /// \param a_light The light to add to the world, or null to leave the world
+  /// without lights.
   void set_light(std::unique_ptr<::Light> a_light);
 
+  /// Add a light to the world.
+  /// \param a_light The light to add to the world.
+  void add_light(const ::Light& a_light);
+
+  /// Get the number of lights in the World.
+  /// \return The number of lights.
+  int light_count() const
+  {
+    return static_cast<int>(lights_.size());
+  }
+
+  /// Get light of given index in world.
+  /// \param a_light_index The index of the light to get.
+  /// \return The light at the given index.
+  const ::Light& light(int a_light_index) const
+  {
+    return lights_.at(a_light_index);
+  }
+
+  /// Get the intensity lights must exceed to be shaded.
+  /// \return The intensity threshold.
+  Scalar light_threshold() const
+  {
+    return light_threshold_;
+  }
+
+  /// Set the intensity lights must exceed to be shaded. Lights whose
+  /// brightest channel is at or below the threshold are skipped, including
+  /// their ambient contribution.
+  /// \param a_light_threshold The intensity threshold (0.0 by default).
+  void set_light_threshold(Scalar a_light_threshold)
+  {
+    light_threshold_ = a_light_threshold;
+  }
+
   /// Get the intersections of a ray with the world.
   /// \param a_ray The ray to intersect with the world.
   /// \return A list of intersections ordered in increasing T value.
   std::vector<Intersection> intersect(const Ray& a_ray) const;
 
-  /// Calculate the color at a hit given calculations.
+  /// Get the intersections of a ray with the world into a list.
+  /// Reusing the list between calls avoids allocating once it has grown.
+  /// \param a_ray The ray to intersect with the world.
+  /// \param a_intersections Receives the intersections ordered in increasing
+  /// T value, replacing its contents.
+  void intersect(const Ray& a_ray,
+      std::vector<Intersection>& a_intersections) const;
+
+  /// Find the closest intersection in front of the ray origin without
+  /// building the list of all intersections.
+  /// \param a_ray The ray to intersect with the world.
+  /// \param a_t Receives the distance to the closest intersection.
+  /// \return The closest object hit, or nullptr if the ray hits nothing.
+  const Shape* closest_hit(const Ray& a_ray, Scalar& a_t) const;
+
+  /// Find the closest intersection in front of the origin of each ray of a
+  /// packet. Every lane gets the same result as closest_hit() would give.
+  /// \param a_packet The rays to intersect with the world.
+  /// \param a_objects Receives the closest object hit by each lane, or
+  /// nullptr for lanes that hit nothing.
+  /// \param a_t Receives the distance to the closest intersection of each lane.
+  template <int N>
+  void closest_hits(const RayPacket<N>& a_packet, const Shape** a_objects,
+      Scalar* a_t) const;
+
+  /// Determine if a ray hits any object before a given distance.
+  /// Stops at the first object found.
+  /// \param a_ray The ray to intersect with the world.
+  /// \param a_t_max The distance along the ray to search up to.
+  /// \return True if an object is hit between the ray origin and a_t_max.
+  bool any_hit(const Ray& a_ray, Scalar a_t_max) const;
+
+  /// Calculate the color at a hit given calculations, summing the
+  /// contribution of every light. Lights behind the surface only add their
+  /// ambient contribution and cast no shadow ray. The shadow rays of the
+  /// other lights are gathered before any of them are traced.
   /// \param a_computations The calculations at the hit object.
+  /// \param a_shadow_cache Optional cache of the last shadowing object.
   /// \return The color at the ray trace hit.
-  Color shade_hit(const Computations& a_computations) const;
+  Color shade_hit(const Computations& a_computations,
+      ShadowCache* a_shadow_cache = nullptr) const;
+
+  /// Calculate the color seen along a ray given its closest hit.
+  /// \param a_ray The ray cast into the world.
+  /// \param a_object The closest object hit, or nullptr for no hit.
+  /// \param a_t The distance to the closest hit.
+  /// \param a_shadow_cache Optional cache of the last shadowing object.
+  /// \return The color at the hit, or black if nothing was hit.
+  Color color_for_hit(const Ray& a_ray, const Shape* a_object,
+      Scalar a_t, ShadowCache* a_shadow_cache = nullptr) const;
 
   /// Calculate the color where a ray hits the world.
+  /// Does not allocate.
   /// \param a_ray The ray to cast into the world.
+  /// \param a_shadow_cache Optional cache of the last shadowing object.
   /// \return  The color where the ray hits the world.
-  Color color_at(const Ray& a_ray) const;
+  Color color_at(const Ray& a_ray,
+      ShadowCache* a_shadow_cache = nullptr) const;
 
-  /// Determine if a point is in the shadow of an object.
+  /// Determine if a point is in the shadow of an object from the first light.
+  /// Does not allocate.
   /// \param a_point The point to check for being in a shadow.
+  /// \param a_shadow_cache Optional cache of the last shadowing object. The
+  /// object it remembers is tested before searching the whole world.
+  /// \return True if the point is in a shadow, false if there are no lights.
+  bool is_shadowed(const Tuple& a_point,
+      ShadowCache* a_shadow_cache = nullptr) const;
+
+  /// Determine if a point is in the shadow of an object from a light.
+  /// Does not allocate.
+  /// \param a_point The point to check for being in a shadow.
+  /// \param a_light The light casting the shadow.
+  /// \param a_shadow_cache Optional cache of the last shadowing object.
   /// \return True if the point is in a shadow.
-  bool is_shadowed(const Tuple& a_point) const;
+  bool is_shadowed(const Tuple& a_point, const ::Light& a_light,
+      ShadowCache* a_shadow_cache = nullptr) const;
 
 private:
-  std::vector<std::unique_ptr<Sphere>> objects_; ///< The worlds objects.
-  std::unique_ptr<::Light> light_;               ///< The worlds light.
+  bool object_distances(int a_object, const Ray& a_ray, Scalar& a_t_1,
+      Scalar& a_t_2) const;
+  template <int N>
+  void object_packet_hits(int a_object, const RayPacket<N>& a_packet,
+      RayPacketHits<N>& a_hits) const;
+  bool blocks(int a_object, const Ray& a_ray, Scalar a_t_max) const;
+  const Plane* nearest_plane(const Ray& a_ray, Scalar& a_t_max) const;
+  bool plane_blocks(const Ray& a_ray, Scalar a_t_max) const;
+  int first_blocker(const Ray& a_ray, Scalar a_t_max) const;
+  bool occluded(const Ray& a_ray, Scalar a_t_max,
+      ShadowCache* a_shadow_cache) const;
+
+  std::vector<std::unique_ptr<Sphere>> objects_; ///< The worlds spheres.
+  SphereStore store_;                            ///< Spheres for intersecting.
+  std::vector<std::unique_ptr<Plane>> planes_;   ///< The worlds planes.
+  std::vector<::Light> lights_;                  ///< The worlds lights.
+  Scalar light_threshold_ = 0;                   ///< Dimmest light shaded.
+  Bvh bvh_;                                      ///< Optional object hierarchy.
 };
 
 /// Get the default world which contains two spheres and a light.
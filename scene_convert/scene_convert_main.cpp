@@ -0,0 +1,27 @@
+#include <iostream>
+
+#include <raytracer/scene_cache.h>
+#include <raytracer/scene_file.h>
+
+/// Convert a scene file to a scene cache that loads without parsing.
+/// Usage: scene_convert <scene_file> <scene_cache>
+int main(int argc, char* argv[])
+{
+  if (argc < 3)
+  {
+    std::cerr << "usage: scene_convert <scene_file> <scene_cache>\n";
+    return 1;
+  }
+
+  Scene scene;
+  std::string error;
+  if (!load_scene(argv[1], scene, error) ||
+      !save_scene_cache(argv[2], scene, error))
+  {
+    std::cerr << error << "\n";
+    return 1;
+  }
+  std::cerr << "converted " << scene.world.object_count() << " spheres and "
+            << scene.world.plane_count() << " planes\n";
+  return 0;
+}
@@ -0,0 +1,65 @@
+#include <fstream>
+#include <iostream>
+
+#include <raytracer/camera.h>
+#include <raytracer/canvas.h>
+#include <raytracer/ppm_writer.h>
+#include <raytracer/scene_cache.h>
+#include <raytracer/scene_file.h>
+#include <raytracer/scheduler.h>
+#include <raytracer/trace.h>
+
+/// Render a scene file, or a scene cache made by scene_convert, to
+/// output.ppm. A timeline of the load and render is written in the Chrome
+/// trace_event format when a trace file is given.
+/// Usage: scene_render <scene_file or scene_cache> [trace_file]
+int main(int argc, char* argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "usage: scene_render <scene_file or scene_cache> "
+                 "[trace_file]\n";
+    return 1;
+  }
+  trace::set_enabled(argc > 2);
+
+  // scene caches are recognized by their extension
+  std::string path = argv[1];
+  bool cache = path.size() > 8 &&
+               path.compare(path.size() - 8, 8, ".rtscene") == 0;
+  Scene scene;
+  std::string error;
+  if (cache ? !load_scene_cache(path, scene, error) :
+              !load_scene(path, scene, error))
+  {
+    std::cerr << error << "\n";
+    return 1;
+  }
+  std::cerr << "loaded " << scene.world.object_count() << " spheres and "
+            << scene.world.plane_count() << " planes in "
+            << scene.load_seconds << " s (bvh " << scene.bvh_seconds
+            << " s)\n";
+
+  Camera& camera = scene.camera;
+  camera.set_thread_count(hardware_thread_count());
+
+  // write rows to the file as soon as they have been rendered
+  std::ofstream outfile;
+  outfile.open("output.ppm");
+  PpmWriter writer(outfile, camera.h_size(), camera.v_size());
+  RenderResult result = camera.render_with_stats(scene.world,
+      [&](const Canvas& a_canvas, int a_rows_done)
+  {
+    writer.write_rows(a_canvas, a_rows_done);
+  });
+  if (RenderStats::enabled)
+    result.stats.write_json(std::cerr);
+
+  if (trace::enabled())
+  {
+    trace::set_enabled(false);
+    std::ofstream trace_file(argv[2]);
+    trace::write_json(trace_file);
+  }
+  return 0;
+}
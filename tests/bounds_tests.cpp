@@ -0,0 +1,60 @@
+#include <catch2/catch.hpp>
+
+#include <raytracer/bounds.h>
+#include <raytracer/matrix.h>
+#include <raytracer/sphere.h>
+#include <raytracer/transform.h>
+
+
+TEST_CASE("A default bounding box is empty", "[bounds]")
+{
+  Bounds b;
+  CHECK(b.is_empty());
+  CHECK(b.surface_area() == 0);
+}
+
+TEST_CASE("Extending a bounding box with points", "[bounds]")
+{
+  Bounds b;
+  b.extend(point(-5, 2, 0));
+  b.extend(point(7, 0, -3));
+  CHECK(b.minimum() == point(-5, 0, -3));
+  CHECK(b.maximum() == point(7, 2, 0));
+  CHECK(b.centroid() == point(1, 1, -1.5));
+  CHECK(b.surface_area() == 2 * (12 * 2 + 2 * 3 + 3 * 12));
+}
+
+TEST_CASE("Transforming a bounding box", "[bounds]")
+{
+  Bounds b(point(-1, -1, -1), point(1, 1, 1));
+  Bounds t = b.transform(translation(1, 2, 3) * scaling(2, 1, 1));
+  CHECK(t.minimum() == point(-1, 1, 2));
+  CHECK(t.maximum() == point(3, 3, 4));
+}
+
+TEST_CASE("The bounds of a transformed sphere", "[bounds]")
+{
+  Sphere s;
+  s.set_transform(translation(0, 5, 0) * scaling(10, 0.01, 10));
+  Bounds b = s.bounds();
+  CHECK(approximately_equal(b.minimum(), point(-10, 4.99, -10)));
+  CHECK(approximately_equal(b.maximum(), point(10, 5.01, 10)));
+}
+
+TEST_CASE("A ray intersecting a bounding box", "[bounds]")
+{
+  Bounds b(point(-1, -1, -1), point(1, 1, 1));
+  Tuple origin = point(0, 0, -5);
+  Tuple inverse = inverse_direction(vector(0, 0, 1));
+  CHECK(b.intersects(origin, inverse, 0, 100));
+  CHECK_FALSE(b.intersects(origin, inverse, 0, 3));
+  CHECK_FALSE(b.intersects(point(2, 0, -5), inverse, 0, 100));
+}
+
+TEST_CASE("A ray lying in the face of a bounding box", "[bounds]")
+{
+  Bounds b(point(-1, -1, -1), point(1, 1, 1));
+  Tuple inverse = inverse_direction(vector(0, 0, 1));
+  CHECK(b.intersects(point(1, 0, -5), inverse, 0, 100));
+  CHECK(b.intersects(point(-1, 1, -5), inverse, 0, 100));
+}
@@ -0,0 +1,94 @@
+#include <catch2/catch.hpp>
+
+#include <random>
+
+#include <raytracer/bvh.h>
+#include <raytracer/sphere.h>
+#include <raytracer/transform.h>
+#include <raytracer/world.h>
+
+
+namespace
+{
+
+World random_world(int a_count)
+{
+  std::mt19937 generator(7);
+  std::uniform_real_distribution<double> position(-20, 20);
+  std::uniform_real_distribution<double> size(0.1, 1.5);
+  World world;
+  world.set_light(Light::new_ptr(point(-10, 10, -10), Color(1, 1, 1)));
+  for (int i = 0; i < a_count; ++i)
+  {
+    auto sphere = Sphere::new_ptr();
+    sphere->set_transform(
+        translation(position(generator), position(generator), position(generator)) *
+        scaling(size(generator), size(generator), size(generator)));
+    world.add_object(std::move(sphere));
+  }
+  return world;
+}
+
+} // namespace
+
+TEST_CASE("Building a hierarchy over a world", "[bvh]")
+{
+  World w = random_world(100);
+  CHECK(w.bvh().empty());
+  w.build_bvh();
+  REQUIRE_FALSE(w.bvh().empty());
+  const BvhNode& root = w.bvh().nodes()[0];
+  for (int i = 0; i < w.object_count(); ++i)
+  {
+    Bounds b = w.object(i).bounds();
+    CHECK(root.bounds.minimum().x() <= b.minimum().x());
+    CHECK(root.bounds.maximum().z() >= b.maximum().z());
+  }
+}
+
+TEST_CASE("Adding an object removes the hierarchy", "[bvh]")
+{
+  World w = default_world();
+  w.build_bvh();
+  CHECK_FALSE(w.bvh().empty());
+  w.add_object(Sphere::new_ptr());
+  CHECK(w.bvh().empty());
+}
+
+TEST_CASE("Intersecting with a hierarchy matches testing every object", "[bvh]")
+{
+  World w = random_world(500);
+  std::mt19937 generator(11);
+  std::uniform_real_distribution<double> coordinate(-1, 1);
+  std::vector<Ray> rays;
+  for (int i = 0; i < 200; ++i)
+  {
+    Tuple direction = vector(coordinate(generator), coordinate(generator),
+                             coordinate(generator)).normalize();
+    rays.emplace_back(point(0, 0, -30) - direction * 5, direction);
+  }
+  std::vector<Intersections> expected;
+  for (auto& ray : rays)
+    expected.push_back(w.intersect(ray));
+
+  w.build_bvh();
+  bool all_equal = true;
+  for (size_t i = 0; i < rays.size(); ++i)
+  {
+    Intersections xs = w.intersect(rays[i]);
+    all_equal = all_equal && xs.size() == expected[i].size();
+    for (size_t j = 0; all_equal && j < xs.size(); ++j)
+      all_equal = xs[j].t() == expected[i][j].t();
+  }
+  CHECK(all_equal);
+}
+
+TEST_CASE("A hierarchy over the default world shades the same", "[bvh]")
+{
+  World w = default_world();
+  w.build_bvh();
+  Ray r(point(0, 0, -5), vector(0, 0, 1));
+  CHECK(approximately_equal(w.color_at(r), Color(0.38066, 0.47583, 0.2855)));
+  CHECK(w.is_shadowed(point(10, -10, 10)));
+  CHECK_FALSE(w.is_shadowed(point(-20, 20, -20)));
+}
@@ -1,7 +1,10 @@
 #include <catch2/catch.hpp>
 
+#include <algorithm>
+
 #include <raytracer/camera.h>
 #include <raytracer/matrix.h>
+#include <raytracer/scenes.h>
 #include <raytracer/test_utils.h>
 #include <raytracer/transform.h>
 #include <raytracer/world.h>
@@ -14,7 +17,7 @@ TEST_CASE("Constructing a camera", "[camera]")
   Camera c(hSize, vSize, field_of_view);
   CHECK(c.h_size() == 160);
   CHECK(c.v_size() == 120);
-  CHECK(c.field_of_view() == M_PI/2);
+  CHECK(c.field_of_view() == Scalar(M_PI/2));
   CHECK(c.transform() == Matrix::identity_matrix());
 }
 
@@ -52,7 +55,11 @@ TEST_CASE("Constructing a ray when the camera is transformed", "[camera]")
   Camera c(201, 101, M_PI/2);
     c.set_transform(rotation_y(M_PI / 4) * translation(0, -2, 5));
   Ray r = c.ray_for_pixel(100, 50);
+#if defined(RAYTRACER_FLOAT)
+  CHECK(nearly_equal(r.origin(), point(0, 2, -5)));
+#else
   CHECK(r.origin() == point(0, 2, -5));
+#endif
   CHECK(approximately_equal(r.direction(), vector(sqrt(2)/2, 0, -sqrt(2)/2)));
 }
 
@@ -67,3 +74,155 @@ TEST_CASE("Rendering a world with a camera", "[camera]")
   auto image = c.render(w);
   CHECK(approximately_equal(image.pixel_at(5, 5), Color(0.38066, 0.47583, 0.2855)));
 }
+
+TEST_CASE("Rendering with several threads matches rendering with one", "[camera]")
+{
+  World w = default_world();
+  Camera c(37, 23, M_PI/2);
+  c.set_transform(view_transform(point(0, 0, -5), point(0, 0, 0), vector(0, 1, 0)));
+  c.set_tile_size(8);
+  auto serial = c.render(w);
+  c.set_thread_count(4);
+  auto parallel = c.render(w);
+  bool identical = true;
+  for (int y = 0; y < c.v_size(); ++y)
+    for (int x = 0; x < c.h_size(); ++x)
+      identical = identical && serial.pixel_at(x, y) == parallel.pixel_at(x, y);
+  CHECK(identical);
+}
+
+TEST_CASE("Stepped ray directions match rays built per pixel", "[camera]")
+{
+  Camera c(21, 11, M_PI/2);
+  c.set_transform(rotation_y(M_PI / 4) * translation(0, -2, 5));
+#if defined(RAYTRACER_FLOAT)
+  CHECK(nearly_equal(c.origin(), point(0, 2, -5)));
+#else
+  CHECK(c.origin() == point(0, 2, -5));
+#endif
+  std::vector<Tuple> directions;
+  c.ray_directions(3, 2, 21, 5, directions);
+  REQUIRE(directions.size() == 18 * 3);
+  bool matching = true;
+  for (int y = 2; y < 5; ++y)
+    for (int x = 3; x < 21; ++x)
+      matching = matching && nearly_equal(directions[(y - 2) * 18 + x - 3],
+                                          c.ray_for_pixel(x, y).direction());
+  CHECK(matching);
+}
+
+TEST_CASE("Rendering reports completed rows in order", "[camera]")
+{
+  World w = default_world();
+  Camera c(20, 37, M_PI/2);
+  c.set_tile_size(8);
+  c.set_thread_count(3);
+  std::vector<int> rows_done;
+  auto image = c.render(w, [&](const Canvas&, int a_rows_done)
+  {
+    rows_done.push_back(a_rows_done);
+  });
+  REQUIRE_FALSE(rows_done.empty());
+  CHECK(std::is_sorted(rows_done.begin(), rows_done.end()));
+  CHECK(rows_done.back() == 37);
+}
+
+TEST_CASE("A camera renders tiles of at least one pixel", "[camera]")
+{
+  World w = default_world();
+  Camera c(5, 3, M_PI/2);
+  Canvas expected = c.render(w);
+  c.set_tile_size(0);
+  CHECK(c.tile_size() == 1);
+  c.set_tile_size(-3);
+  CHECK(c.tile_size() == 1);
+  Canvas tiled = c.render(w);
+  Canvas progressive = c.render_progressive(w, Camera::PassDoneCallback());
+  bool matching = true;
+  for (int y = 0; y < expected.height(); ++y)
+  {
+    for (int x = 0; x < expected.width(); ++x)
+    {
+      matching = matching && tiled.pixel_at(x, y) == expected.pixel_at(x, y) &&
+                 progressive.pixel_at(x, y) == expected.pixel_at(x, y);
+    }
+  }
+  CHECK(matching);
+}
+
+TEST_CASE("Rendering with ray packets matches single rays", "[camera]")
+{
+  World w = chapter_7_world();
+  Camera c = chapter_7_camera(37, 23);
+  c.set_tile_size(7);
+  Canvas expected = c.render(w);
+  for (int packet_size : {4, 8, 16})
+  {
+    c.set_packet_size(packet_size);
+    CHECK(c.packet_size() == packet_size);
+    Canvas image = c.render(w);
+    bool matching = true;
+    for (int y = 0; y < image.height(); ++y)
+      for (int x = 0; x < image.width(); ++x)
+        matching = matching && image.pixel_at(x, y) == expected.pixel_at(x, y);
+    CHECK(matching);
+  }
+  c.set_packet_size(3);
+  CHECK(c.packet_size() == 1);
+}
+
+TEST_CASE("Rendering with shadow caches matches rendering without", "[camera]")
+{
+  World w = chapter_7_world();
+  Camera c = chapter_7_camera(37, 23);
+  c.set_tile_size(7);
+  c.set_thread_count(2);
+  c.set_shadow_cache(false);
+  CHECK_FALSE(c.shadow_cache());
+  ShadowCacheStats stats;
+  Canvas expected = c.render(w, Camera::RowsDoneCallback(), &stats);
+  CHECK(stats.lookups == 0);
+  c.set_shadow_cache(true);
+  Canvas image = c.render(w, Camera::RowsDoneCallback(), &stats);
+  bool matching = true;
+  for (int y = 0; y < image.height(); ++y)
+    for (int x = 0; x < image.width(); ++x)
+      matching = matching && image.pixel_at(x, y) == expected.pixel_at(x, y);
+  CHECK(matching);
+  CHECK(stats.lookups > 0);
+  CHECK(stats.hits > 0);
+}
+
+TEST_CASE("Rendering progressively refines to the full render", "[camera]")
+{
+  World w = chapter_7_world();
+  Camera c = chapter_7_camera(37, 23);
+  c.set_tile_size(6);
+  c.set_thread_count(3);
+  Canvas expected = c.render(w);
+  std::vector<int> steps;
+  Canvas image = c.render_progressive(w, [&](const Canvas& a_canvas,
+                                             int a_step)
+  {
+    steps.push_back(a_step);
+    bool matching = true;
+    for (int y = 0; y < a_canvas.height(); ++y)
+    {
+      for (int x = 0; x < a_canvas.width(); ++x)
+      {
+        // each pixel shows the traced pixel at the corner of its block
+        int traced_x = x / a_step * a_step;
+        int traced_y = y / a_step * a_step;
+        matching = matching && a_canvas.pixel_at(x, y) ==
+                               expected.pixel_at(traced_x, traced_y);
+      }
+    }
+    CHECK(matching);
+  });
+  CHECK(steps == std::vector<int>({4, 2, 1}));
+  bool matching = true;
+  for (int y = 0; y < image.height(); ++y)
+    for (int x = 0; x < image.width(); ++x)
+      matching = matching && image.pixel_at(x, y) == expected.pixel_at(x, y);
+  CHECK(matching);
+}
@@ -1,5 +1,7 @@
 #include <catch2/catch.hpp>
 
+#include <sstream>
+
 #include <raytracer/canvas.h>
 #include <raytracer/tuple.h>
 
@@ -101,3 +103,57 @@ TEST_CASE("PPM files are terminated by a newline", "[canvas]")
   std::string ppm = c.to_ppm_string();
   CHECK(EndsInNewLine(ppm));
 }
+
+TEST_CASE("Writing pixels through a view of a canvas", "[canvas]")
+{
+  Canvas c(10, 20);
+  CanvasView v = c.view(2, 3, 4, 5);
+  CHECK(v.x() == 2);
+  CHECK(v.y() == 3);
+  CHECK(v.width() == 4);
+  CHECK(v.height() == 5);
+  Color red(1, 0, 0);
+  v.at(1, 2) = red;
+  v.row(4)[3] = red;
+  CHECK(c.pixel_at(3, 5) == red);
+  CHECK(c.pixel_at(5, 7) == red);
+}
+
+TEST_CASE("A view is clipped to the canvas", "[canvas]")
+{
+  Canvas c(10, 20);
+  CanvasView v = c.view(8, 16, 16, 16);
+  CHECK(v.width() == 2);
+  CHECK(v.height() == 4);
+  CanvasView r = c.row(19);
+  CHECK(r.y() == 19);
+  CHECK(r.width() == 10);
+  CHECK(r.height() == 1);
+}
+
+TEST_CASE("Constructing a binary PPM file", "[canvas]")
+{
+  Canvas c(2, 1);
+  c.write_pixel(0, 0, Color(1.5, 0.5, 0));
+  c.write_pixel(1, 0, Color(-0.5, 0, 1));
+  std::ostringstream out;
+  c.to_ppm_file(out, PpmFormat::P6);
+  std::string expected = std::string("P6\n2 1\n255\n") + '\xff' + '\x80' +
+                         '\0' + '\0' + '\0' + '\xff';
+  CHECK(out.str() == expected);
+}
+
+TEST_CASE("Writing a PPM file a row at a time", "[canvas]")
+{
+  Canvas c(10, 3);
+  c.set_all_pixel_colors(Color(1, 0.8, 0.6));
+  c.write_pixel(4, 1, Color(0, 0.5, 0));
+  std::ostringstream out;
+  PpmWriter writer(out, c.width(), c.height());
+  writer.write_rows(c, 2);
+  CHECK(writer.rows_written() == 2);
+  writer.write_rows(c, 1);
+  writer.write_rows(c, 5);
+  CHECK(writer.rows_written() == 3);
+  CHECK(out.str() == c.to_ppm_string());
+}
@@ -1,6 +1,7 @@
 #include <catch2/catch.hpp>
 
 #include <raytracer/intersection.h>
+#include <raytracer/sphere.h>
 #include <raytracer/transform.h>
 
 
@@ -8,9 +8,9 @@ TEST_CASE("The default material", "[materials]")
 {
   Material m;
   CHECK(m.color() == Color(1, 1, 1));
-  CHECK(m.ambient() == 0.1);
-  CHECK(m.diffuse() == 0.9);
-  CHECK(m.specular() == 0.9);
+  CHECK(m.ambient() == Scalar(0.1));
+  CHECK(m.diffuse() == Scalar(0.9));
+  CHECK(m.specular() == Scalar(0.9));
   CHECK(m.shininess() == 200.0);
 }
 
@@ -101,6 +101,22 @@ TEST_CASE("Lighting with the surface in shadow", "[materials]")
   CHECK(nearly_equal(result, Color(0.1, 0.1, 0.1)));
 }
 
+TEST_CASE("The specular factor matches pow() for any shininess", "[materials]")
+{
+  Material m;
+  for (Scalar shininess : {0.0, 1.0, 10.0, 200.0, 1024.0, 2.5, 1025.0})
+  {
+    m.set_shininess(shininess);
+    for (Scalar cosine : {0.0, 0.125, 0.5, 0.9, 0.999, 1.0})
+    {
+      Scalar expected = std::pow(cosine, shininess);
+      Scalar factor = m.specular_factor(cosine);
+      CHECK(std::abs(factor - expected) <= 1.0e-5 * expected);
+    }
+  }
+  CHECK(Material(Color(1, 1, 1), 0.1, 0.9, 0.9, 3).specular_factor(0.5) == 0.125);
+}
+
 #if 0
 TEST_CASE("Lighting with a pattern applied", "[materials]")
 {
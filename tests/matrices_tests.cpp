@@ -1,6 +1,7 @@
 #include <catch2/catch.hpp>
 
 #include <raytracer/matrix.h>
+#include <raytracer/test_utils.h>
 
 TEST_CASE("Constructing and inspecting a 4x4 matrix", "[matrices]")
 {
@@ -279,9 +280,17 @@ TEST_CASE("Calculating the inverse of a matrix", "[matrices]")
   Matrix B = A.inverse();
   CHECK(A.determinant() == 532);
   CHECK(A.cofactor(2, 3) == -160);
+#if defined(RAYTRACER_FLOAT)
+  CHECK(nearly_equal(B[3][2], -160.0/532.0));
+#else
   CHECK(B[3][2] == -160.0/532.0);
+#endif
   CHECK(A.cofactor(3, 2) == 105);
+#if defined(RAYTRACER_FLOAT)
+  CHECK(nearly_equal(B[2][3], 105.0/532.0));
+#else
   CHECK(B[2][3] == 105.0/532.0);
+#endif
   Matrix expected = {
     {0.21805, 0.45113, 0.24060, -0.04511},
     {-0.80827, -1.45677, -0.44361, 0.52068},
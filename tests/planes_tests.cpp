@@ -0,0 +1,124 @@
+#include <catch2/catch.hpp>
+
+#include <raytracer/camera.h>
+#include <raytracer/intersection.h>
+#include <raytracer/plane.h>
+#include <raytracer/scenes.h>
+#include <raytracer/transform.h>
+#include <raytracer/world.h>
+
+TEST_CASE("The normal of a plane is constant everywhere", "[planes]")
+{
+  Plane p;
+  CHECK(p.local_normal_at(point(0, 0, 0)) == vector(0, 1, 0));
+  CHECK(p.local_normal_at(point(10, 0, -10)) == vector(0, 1, 0));
+  CHECK(p.local_normal_at(point(-5, 0, 150)) == vector(0, 1, 0));
+}
+
+TEST_CASE("Intersect with a ray parallel to the plane", "[planes]")
+{
+  Plane p;
+  Ray r(point(0, 10, 0), vector(0, 0, 1));
+  Intersections xs;
+  p.local_intersect(r, xs);
+  CHECK(xs.empty());
+  Scalar t;
+  CHECK_FALSE(p.intersect_distance(r, t));
+}
+
+TEST_CASE("Intersect with a coplanar ray", "[planes]")
+{
+  Plane p;
+  Ray r(point(0, 0, 0), vector(0, 0, 1));
+  Intersections xs;
+  p.local_intersect(r, xs);
+  CHECK(xs.empty());
+  Scalar t;
+  CHECK_FALSE(p.intersect_distance(r, t));
+}
+
+TEST_CASE("A ray intersecting a plane from above", "[planes]")
+{
+  Plane p;
+  Ray r(point(0, 1, 0), vector(0, -1, 0));
+  Intersections xs;
+  p.local_intersect(r, xs);
+  REQUIRE(xs.size() == 1);
+  CHECK(xs[0].t() == 1);
+  CHECK(xs[0].object() == p);
+}
+
+TEST_CASE("A ray intersecting a plane from below", "[planes]")
+{
+  Plane p;
+  Ray r(point(0, -1, 0), vector(0, 1, 0));
+  Intersections xs;
+  p.local_intersect(r, xs);
+  REQUIRE(xs.size() == 1);
+  CHECK(xs[0].t() == 1);
+  CHECK(xs[0].object() == p);
+}
+
+TEST_CASE("The distance to a transformed plane matches its intersection", "[planes]")
+{
+  Plane p;
+  p.set_transform(translation(0, 0, 5) * rotation_y(M_PI / 4) *
+                  rotation_x(M_PI / 2));
+  Ray r(point(0.5, 1, -5), vector(0.1, 0, 1).normalize());
+  Intersections xs = p.intersect(r);
+  REQUIRE(xs.size() == 1);
+  Scalar t;
+  REQUIRE(p.intersect_distance(r, t));
+  CHECK(t == Approx(xs[0].t()));
+  CHECK(approximately_equal(p.normal_at(r.position(t)),
+                            vector(sqrt(2) / 2, 0, sqrt(2) / 2)));
+}
+
+TEST_CASE("A plane floor is hit and casts shadows in a world", "[planes]")
+{
+  World w = default_world();
+  w.add_object(Plane::new_ptr());
+  w.plane(0).set_transform(translation(0, -1, 0));
+  CHECK(w.plane_count() == 1);
+
+  Ray down(point(3, 5, 0), vector(0, -1, 0));
+  Scalar t;
+  CHECK(w.closest_hit(down, t) == &w.plane(0));
+  CHECK(t == 6);
+  Intersections xs = w.intersect(down);
+  REQUIRE(xs.size() == 1);
+  CHECK(xs[0].object() == w.plane(0));
+
+  // the spheres are in front of the floor
+  Ray ahead(point(0, 0, -5), vector(0, 0, 1));
+  CHECK(w.closest_hit(ahead, t) == &w.object(0));
+  CHECK(t == 4);
+  CHECK(w.intersect(ahead).size() == 4);
+
+  CHECK(w.is_shadowed(point(0, -2, 0)));
+  ShadowCache cache;
+  CHECK(w.is_shadowed(point(0, -2, 0), &cache));
+  CHECK_FALSE(w.is_shadowed(point(3, 0, 0), &cache));
+}
+
+TEST_CASE("Rendering planes with ray packets matches single rays", "[planes]")
+{
+  World w = chapter_9_world();
+  CHECK(w.plane_count() == 3);
+  CHECK(w.object_count() == 3);
+  Camera c = chapter_7_camera(37, 23);
+  c.set_tile_size(7);
+  Canvas expected = c.render(w);
+  CHECK_FALSE(expected.pixel_at(18, 22) == Color(0, 0, 0));
+  w.build_bvh();
+  for (int packet_size : {1, 4, 8, 16})
+  {
+    c.set_packet_size(packet_size);
+    Canvas image = c.render(w);
+    bool matching = true;
+    for (int y = 0; y < image.height(); ++y)
+      for (int x = 0; x < image.width(); ++x)
+        matching = matching && image.pixel_at(x, y) == expected.pixel_at(x, y);
+    CHECK(matching);
+  }
+}
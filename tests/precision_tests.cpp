@@ -0,0 +1,57 @@
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+#include <raytracer/camera.h>
+#include <raytracer/canvas.h>
+#include <raytracer/scenes.h>
+#include <raytracer/world.h>
+
+TEST_CASE("The chapter 7 scene matches the double precision render", "[precision]")
+{
+  // the reference was rendered by the double precision build
+  std::ifstream file(TEST_DATA_DIR "/chapter_7_200x100.ppm", std::ios::binary);
+  REQUIRE(file);
+  std::string expected((std::istreambuf_iterator<char>(file)),
+                       std::istreambuf_iterator<char>());
+
+  Camera camera = chapter_7_camera(200, 100);
+  Canvas image = camera.render(chapter_7_world());
+  std::ostringstream out;
+  image.to_ppm_file(out, PpmFormat::P6);
+  std::string actual = out.str();
+  REQUIRE(actual.size() == expected.size());
+
+  // count the pixels where any channel differs by more than 2 levels
+  size_t header_size = std::string("P6\n200 100\n255\n").size();
+  int differing_pixels = 0;
+  for (size_t i = header_size; i < actual.size(); i += 3)
+  {
+    int difference = 0;
+    for (size_t channel = i; channel < i + 3; ++channel)
+    {
+      int value = static_cast<unsigned char>(actual[channel]);
+      int reference = static_cast<unsigned char>(expected[channel]);
+      difference = std::max(difference, std::abs(value - reference));
+    }
+    if (difference > 2)
+      ++differing_pixels;
+  }
+
+  if (std::is_same<Scalar, double>::value)
+  {
+    // fused multiply-adds may round a few channels differently
+    CHECK(differing_pixels == 0);
+  }
+  else
+  {
+    // single precision moves a few shadow and surface edges by a pixel
+    CHECK(differing_pixels <= 20);
+  }
+}
@@ -0,0 +1,83 @@
+#include <catch2/catch.hpp>
+
+#include <sstream>
+#include <string>
+
+#include <raytracer/camera.h>
+#include <raytracer/matrix.h>
+#include <raytracer/render_stats.h>
+#include <raytracer/scenes.h>
+#include <raytracer/transform.h>
+
+TEST_CASE("Rendering with statistics gives the canvas of a plain render", "[render_stats]")
+{
+  World w = chapter_7_world();
+  Camera c = chapter_7_camera(37, 23);
+  c.set_tile_size(7);
+  c.set_thread_count(2);
+  Canvas expected = c.render(w);
+  for (int packet_size : {1, 8})
+  {
+    c.set_packet_size(packet_size);
+    int rows_done = 0;
+    RenderResult result = c.render_with_stats(w, [&](const Canvas&, int a_rows_done)
+    {
+      rows_done = a_rows_done;
+    });
+    CHECK(rows_done == 23);
+    bool matching = true;
+    for (int y = 0; y < expected.height(); ++y)
+      for (int x = 0; x < expected.width(); ++x)
+        matching = matching && result.canvas.pixel_at(x, y) == expected.pixel_at(x, y);
+    CHECK(matching);
+
+    const RenderStats& stats = result.stats;
+    if (RenderStats::enabled)
+    {
+      CHECK(stats.primary_rays == 37 * 23);
+      CHECK(stats.shadow_rays > 0);
+      CHECK(stats.sphere_hits > 0);
+      CHECK(stats.sphere_misses() > 0);
+      CHECK(stats.matrix_inverses == 0);
+      CHECK(stats.trace_seconds > 0);
+      CHECK(stats.shade_seconds > 0);
+    }
+    else
+    {
+      CHECK(stats.primary_rays == 0);
+      CHECK(stats.sphere_intersects == 0);
+      CHECK(stats.trace_seconds == 0);
+    }
+  }
+}
+
+TEST_CASE("Hot path counters are kept per thread", "[render_stats]")
+{
+  stats::take();
+  Matrix inverse = translation(1, 2, 3).inverse();
+  CHECK(inverse == translation(-1, -2, -3));
+  RenderStats taken = stats::take();
+  CHECK(taken.matrix_inverses == (RenderStats::enabled ? 1 : 0));
+  CHECK(stats::take().matrix_inverses == 0);
+}
+
+TEST_CASE("Render statistics are written as JSON", "[render_stats]")
+{
+  RenderStats stats;
+  stats.primary_rays = 6;
+  stats.sphere_intersects = 10;
+  stats.sphere_hits = 4;
+  stats.trace_seconds = 0.5;
+  RenderStats more = stats;
+  stats.merge(more);
+  CHECK(stats.primary_rays == 12);
+
+  std::ostringstream out;
+  stats.write_json(out);
+  std::string json = out.str();
+  CHECK(json.find("\"primary_rays\": 12,") != std::string::npos);
+  CHECK(json.find("\"sphere_misses\": 12,") != std::string::npos);
+  CHECK(json.find("\"trace\": 1,") != std::string::npos);
+  CHECK(json.find(RenderStats::enabled ? "\"enabled\": true" :
+                                         "\"enabled\": false") != std::string::npos);
+}
@@ -0,0 +1,77 @@
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <raytracer/row_reporter.h>
+
+
+TEST_CASE("Rows are reported once every tile of their band is done", "[row_reporter]")
+{
+  std::vector<int> rows_done;
+  RowReporter reporter(2, 8, 20, [&](int a_rows_done)
+  {
+    rows_done.push_back(a_rows_done);
+  });
+  reporter.tile_done(1);
+  reporter.tile_done(0);
+  CHECK(rows_done.empty());
+  reporter.tile_done(1);
+  CHECK(rows_done.empty());
+  reporter.tile_done(0);
+  CHECK(rows_done == std::vector<int>({16}));
+  reporter.tile_done(2);
+  reporter.tile_done(2);
+  CHECK(rows_done == std::vector<int>({16, 20}));
+}
+
+TEST_CASE("Other threads keep finishing tiles while rows are reported", "[row_reporter]")
+{
+  std::mutex mutex;
+  std::condition_variable changed;
+  bool reporting = false;
+  bool release = false;
+  std::vector<int> rows_done;
+  std::vector<std::thread::id> reporters;
+  RowReporter reporter(1, 8, 20, [&](int a_rows_done)
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    rows_done.push_back(a_rows_done);
+    reporters.push_back(std::this_thread::get_id());
+    reporting = true;
+    changed.notify_all();
+    changed.wait(lock, [&] { return release; });
+  });
+
+  // the first report blocks until the other tiles are done
+  std::thread first([&] { reporter.tile_done(0); });
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [&] { return reporting; });
+  }
+  // the timeout only stops a broken reporter hanging the tests
+  auto others = std::async(std::launch::async, [&]
+  {
+    reporter.tile_done(1);
+    reporter.tile_done(2);
+  });
+  bool others_finished =
+      others.wait_for(std::chrono::seconds(10)) == std::future_status::ready;
+  CHECK(others_finished);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    release = true;
+    changed.notify_all();
+  }
+  first.join();
+  others.wait();
+
+  // the reporting thread reports the rows completed meanwhile in one call
+  CHECK(rows_done == std::vector<int>({8, 20}));
+  REQUIRE(reporters.size() == 2);
+  CHECK(reporters[0] == reporters[1]);
+}
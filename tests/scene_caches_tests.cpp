@@ -0,0 +1,147 @@
+#include <catch2/catch.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include <raytracer/camera.h>
+#include <raytracer/bvh.h>
+#include <raytracer/canvas.h>
+#include <raytracer/material.h>
+#include <raytracer/matrix.h>
+#include <raytracer/scene_cache.h>
+#include <raytracer/scene_file.h>
+#include <raytracer/sphere.h>
+#include <raytracer/sphere_store.h>
+
+TEST_CASE("A scene cache loads the scene it was saved from", "[scene_caches]")
+{
+  // the chapter 9 scene has planes as well as spheres
+  for (const char* path : {SCENES_DIR "/chapter_7.scene",
+                           SCENES_DIR "/chapter_9.scene"})
+  {
+    Scene saved;
+    std::string error;
+    REQUIRE(load_scene(path, saved, error));
+    // a smaller image of the same view keeps the test quick
+    Matrix view = saved.camera.transform();
+    saved.camera = Camera(50, 25, saved.camera.field_of_view());
+    saved.camera.set_transform(view);
+    REQUIRE(save_scene_cache("scene_caches_test.rtscene", saved, error));
+
+    Scene loaded;
+    REQUIRE(load_scene_cache("scene_caches_test.rtscene", loaded, error));
+    std::remove("scene_caches_test.rtscene");
+
+    CHECK(loaded.camera.h_size() == saved.camera.h_size());
+    CHECK(loaded.camera.v_size() == saved.camera.v_size());
+    CHECK(loaded.camera.field_of_view() == saved.camera.field_of_view());
+    CHECK(loaded.camera.transform() == saved.camera.transform());
+    REQUIRE(loaded.world.light_count() == saved.world.light_count());
+    CHECK(loaded.world.light(0).position() == saved.world.light(0).position());
+    CHECK(loaded.world.light(0).intensity() == saved.world.light(0).intensity());
+    REQUIRE(loaded.world.object_count() == saved.world.object_count());
+    const World& world = loaded.world;
+    const World& saved_world = saved.world;
+    for (int i = 0; i < world.object_count(); ++i)
+    {
+      CHECK(world.object(i).transform() == saved_world.object(i).transform());
+      CHECK(world.object(i).material() == saved_world.object(i).material());
+    }
+    CHECK(world.bvh().nodes().size() == saved_world.bvh().nodes().size());
+    CHECK(world.bvh().objects() == saved_world.bvh().objects());
+    REQUIRE(world.plane_count() == saved_world.plane_count());
+    for (int i = 0; i < world.plane_count(); ++i)
+    {
+      CHECK(world.plane(i).transform() == saved_world.plane(i).transform());
+      CHECK(world.plane(i).material() == saved_world.plane(i).material());
+    }
+
+    Canvas expected = saved.camera.render(saved.world);
+    Canvas image = loaded.camera.render(loaded.world);
+    bool matching = true;
+    for (int y = 0; y < image.height(); ++y)
+      for (int x = 0; x < image.width(); ++x)
+        matching = matching && image.pixel_at(x, y) == expected.pixel_at(x, y);
+    CHECK(matching);
+  }
+}
+
+TEST_CASE("Scene caches that cannot be used are rejected", "[scene_caches]")
+{
+  Scene scene;
+  std::string error;
+  CHECK_FALSE(load_scene_cache("missing.rtscene", scene, error));
+  CHECK(error == "cannot open missing.rtscene");
+
+  CHECK_FALSE(load_scene_cache(SCENES_DIR "/chapter_7.scene", scene, error));
+  CHECK(error == SCENES_DIR "/chapter_7.scene: not a scene cache");
+
+  // a cache cut short
+  REQUIRE(load_scene(SCENES_DIR "/chapter_7.scene", scene, error));
+  REQUIRE(save_scene_cache("scene_caches_test.rtscene", scene, error));
+  std::string contents;
+  {
+    std::ifstream file("scene_caches_test.rtscene", std::ios::binary);
+    contents.assign(std::istreambuf_iterator<char>(file),
+                    std::istreambuf_iterator<char>());
+  }
+  {
+    std::ofstream file("scene_caches_test.rtscene", std::ios::binary);
+    file.write(contents.data(),
+               static_cast<std::streamsize>(contents.size() - 8));
+  }
+  CHECK_FALSE(load_scene_cache("scene_caches_test.rtscene", scene, error));
+  CHECK(error == "scene_caches_test.rtscene: damaged scene cache");
+  std::remove("scene_caches_test.rtscene");
+}
+
+TEST_CASE("Scene caches with hierarchies too deep to traverse are rejected", "[scene_caches]")
+{
+  for (int depth : {Bvh::STACK_SIZE - 1, Bvh::STACK_SIZE})
+  {
+    // a chain of branches, each with a leaf as its second child
+    std::vector<BvhNode> nodes(static_cast<size_t>(2 * depth + 1));
+    Bounds bounds(point(-1, -1, -1), point(1, 1, 1));
+    for (int i = 0; i < depth; ++i)
+    {
+      nodes[i].bounds = bounds;
+      nodes[i].first = 2 * depth - i;
+    }
+    for (int i = depth; i <= 2 * depth; ++i)
+    {
+      nodes[i].bounds = bounds;
+      nodes[i].count = 1;
+    }
+    int leaf_object = 0;
+    Bvh bvh;
+    bvh.assign(nodes.data(), static_cast<int>(nodes.size()), &leaf_object, 1);
+
+    std::vector<std::unique_ptr<Sphere>> spheres;
+    spheres.push_back(Sphere::new_ptr());
+    SphereStore store;
+    store.build(spheres);
+    Scene saved;
+    saved.world.set_objects(std::move(spheres), std::move(store),
+                            std::move(bvh));
+    std::string error;
+    REQUIRE(save_scene_cache("scene_caches_test.rtscene", saved, error));
+
+    Scene loaded;
+    bool traversable = depth < Bvh::STACK_SIZE;
+    CHECK(load_scene_cache("scene_caches_test.rtscene", loaded, error) ==
+          traversable);
+    if (traversable)
+    {
+      Scalar t;
+      Ray ray(point(0, 0, -5), vector(0, 0, 1));
+      CHECK(loaded.world.closest_hit(ray, t) == &loaded.world.object(0));
+    }
+    else
+    {
+      CHECK(error == "scene_caches_test.rtscene: damaged scene cache");
+    }
+    std::remove("scene_caches_test.rtscene");
+  }
+}
@@ -0,0 +1,148 @@
+#include <catch2/catch.hpp>
+
+#include <cstdlib>
+#include <string>
+
+#include <raytracer/camera.h>
+#include <raytracer/canvas.h>
+#include <raytracer/material.h>
+#include <raytracer/scene_file.h>
+#include <raytracer/scenes.h>
+#include <raytracer/sphere.h>
+#include <raytracer/transform.h>
+
+namespace
+{
+
+//------------------------------------------------------------------------------
+bool parse(const std::string& a_text, Scene& a_scene, std::string& a_error)
+{
+  return parse_scene(a_text.data(), a_text.size(), a_scene, a_error);
+}
+
+} // namespace
+
+TEST_CASE("Parsing a scene with a camera, light, material and spheres", "[scene_files]")
+{
+  std::string text =
+      "# a comment\n"
+      "camera 40 20 0.5 from 0 1 -5 to 0 0 0 up 0 1 0\n"
+      "\n"
+      "light -10 10 -10 1 0.5 0.25  # trailing comment\n"
+      "material red color 1 0 0 ambient 0.2 diffuse 0.6 specular 0.1 shininess 50\n"
+      "sphere red translate 1 2 3 scale 2 2 2\n"
+      "\tsphere - rotate_z 0.25 shear 1 0 0 0 0 0\r\n"
+      "sphere -";
+  Scene scene;
+  std::string error;
+  REQUIRE(parse(text, scene, error));
+
+  CHECK(scene.camera.h_size() == 40);
+  CHECK(scene.camera.v_size() == 20);
+  CHECK(scene.camera.field_of_view() == Scalar(0.5));
+  CHECK(scene.camera.transform() ==
+        view_transform(point(0, 1, -5), point(0, 0, 0), vector(0, 1, 0)));
+
+  REQUIRE(scene.world.light_count() == 1);
+  CHECK(scene.world.light(0).position() == point(-10, 10, -10));
+  CHECK(scene.world.light(0).intensity() == Color(1, 0.5, 0.25));
+
+  REQUIRE(scene.world.object_count() == 3);
+  const World& world = scene.world;
+  CHECK(world.object(0).material() == Material(Color(1, 0, 0), 0.2, 0.6, 0.1, 50));
+  CHECK(world.object(0).transform() == translation(1, 2, 3) * scaling(2, 2, 2));
+  CHECK(world.object(1).material() == Material());
+  CHECK(world.object(1).transform() ==
+        rotation_z(0.25) * shearing(1, 0, 0, 0, 0, 0));
+  CHECK(world.object(2).transform() == Matrix::identity_matrix(4));
+  CHECK_FALSE(world.bvh().empty());
+  CHECK(scene.load_seconds >= 0);
+}
+
+TEST_CASE("Scene numbers are read like strtod reads them", "[scene_files]")
+{
+  const char* numbers[] = {"0", "-0.5", "0.1", "0.01", "123.456", "+7",
+                           "1e3", "2.5E-2", "0.7853981633974483",
+                           "1234567890.12345", "0.000000000000000000001"};
+  for (const char* number : numbers)
+  {
+    Scene scene;
+    std::string error;
+    REQUIRE(parse(std::string("light ") + number + " 0 0 1 1 1", scene, error));
+    CHECK(scene.world.light(0).position().x() ==
+          static_cast<Scalar>(std::strtod(number, nullptr)));
+  }
+}
+
+TEST_CASE("Scene errors give the line of the statement", "[scene_files]")
+{
+  const char* scenes[][2] = {
+      {"light 1 2 3 1 1 1\nlight 1 2 3 1 1\n", "line 2: invalid light statement"},
+      {"\n\nsphere glass\n", "line 3: invalid sphere statement"},
+      {"sphere - translate 1 2\n", "line 1: invalid sphere statement"},
+      {"sphere - spin 1\n", "line 1: invalid sphere statement"},
+      {"plane floor\n", "line 1: invalid plane statement"},
+      {"material red colour 1 0 0\n", "line 1: invalid material statement"},
+      {"camera 10 10 1 from 0 0 0 to 0 0 1\n", "line 1: invalid camera statement"},
+      {"camera 65537 10 1 from 0 0 0 to 0 0 1 up 0 1 0\n", "line 1: invalid camera statement"},
+      {"camera 10 1e10 1 from 0 0 0 to 0 0 1 up 0 1 0\n", "line 1: invalid camera statement"},
+      {"camera nan 10 1 from 0 0 0 to 0 0 1 up 0 1 0\n", "line 1: invalid camera statement"},
+      {"camera 10 -nan 1 from 0 0 0 to 0 0 1 up 0 1 0\n", "line 1: invalid camera statement"},
+      {"camera 10.5 10 1 from 0 0 0 to 0 0 1 up 0 1 0\n", "line 1: invalid camera statement"},
+      {"light 1 2 3 1 1 1 1\n", "line 1: invalid light statement"},
+      {"light 1 2 x 1 1 1\n", "line 1: invalid light statement"},
+      {"cube\n", "line 1: invalid cube statement"}};
+  for (auto& scene_error : scenes)
+  {
+    Scene scene;
+    std::string error;
+    CHECK_FALSE(parse(scene_error[0], scene, error));
+    CHECK(error == scene_error[1]);
+  }
+
+  Scene scene;
+  std::string error;
+  CHECK_FALSE(load_scene("missing.scene", scene, error));
+  CHECK(error == "cannot open missing.scene");
+}
+
+TEST_CASE("The chapter 7 scene file renders like the chapter 7 world", "[scene_files]")
+{
+  Scene scene;
+  std::string error;
+  REQUIRE(load_scene(SCENES_DIR "/chapter_7.scene", scene, error));
+  CHECK(scene.camera.h_size() == 200);
+  CHECK(scene.camera.v_size() == 100);
+
+  Camera camera = chapter_7_camera(50, 25);
+  CHECK(scene.camera.field_of_view() == camera.field_of_view());
+  CHECK(scene.camera.transform() == camera.transform());
+
+  // a smaller image of the same view keeps the test quick
+  Canvas expected = camera.render(chapter_7_world());
+  Canvas image = camera.render(scene.world);
+  bool matching = true;
+  for (int y = 0; y < image.height(); ++y)
+    for (int x = 0; x < image.width(); ++x)
+      matching = matching && image.pixel_at(x, y) == expected.pixel_at(x, y);
+  CHECK(matching);
+}
+
+TEST_CASE("The chapter 9 scene file renders like the chapter 9 world", "[scene_files]")
+{
+  Scene scene;
+  std::string error;
+  REQUIRE(load_scene(SCENES_DIR "/chapter_9.scene", scene, error));
+  CHECK(scene.world.plane_count() == 3);
+  CHECK(scene.world.object_count() == 3);
+  CHECK(scene.world.plane(1).material() == scene.world.plane(0).material());
+
+  Camera camera = chapter_7_camera(50, 25);
+  Canvas expected = camera.render(chapter_9_world());
+  Canvas image = camera.render(scene.world);
+  bool matching = true;
+  for (int y = 0; y < image.height(); ++y)
+    for (int x = 0; x < image.width(); ++x)
+      matching = matching && image.pixel_at(x, y) == expected.pixel_at(x, y);
+  CHECK(matching);
+}
@@ -0,0 +1,37 @@
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <vector>
+
+#include <raytracer/scheduler.h>
+
+
+TEST_CASE("A scheduler runs every task exactly once", "[scheduler]")
+{
+  Scheduler scheduler(4);
+  CHECK(scheduler.thread_count() == 4);
+  std::vector<std::atomic<int>> runs(1000);
+  for (auto& run : runs)
+    run = 0;
+  scheduler.run(1000, [&](int a_task, int)
+  {
+    ++runs[a_task];
+  });
+  bool all_ran_once = true;
+  for (auto& run : runs)
+    all_ran_once = all_ran_once && run == 1;
+  CHECK(all_ran_once);
+}
+
+TEST_CASE("A scheduler has at least one thread", "[scheduler]")
+{
+  Scheduler scheduler(0);
+  CHECK(scheduler.thread_count() == 1);
+  int runs = 0;
+  scheduler.run(3, [&](int, int a_worker)
+  {
+    CHECK(a_worker == 0);
+    ++runs;
+  });
+  CHECK(runs == 3);
+}
@@ -0,0 +1,94 @@
+#include <catch2/catch.hpp>
+
+#include <raytracer/intersection.h>
+#include <raytracer/shape.h>
+#include <raytracer/test_utils.h>
+#include <raytracer/transform.h>
+
+namespace
+{
+
+/// Shape that records the ray it was intersected with.
+class TestShape : public Shape
+{
+public:
+  void local_intersect(const Ray& a_local_ray,
+      std::vector<Intersection>&) const override
+  {
+    saved_ray = a_local_ray;
+  }
+
+  Tuple local_normal_at(const Tuple& a_local_point) const override
+  {
+    return vector(a_local_point.x(), a_local_point.y(), a_local_point.z());
+  }
+
+  mutable Ray saved_ray{point(0, 0, 0), vector(0, 0, 0)};
+};
+
+} // namespace
+
+TEST_CASE("The default transformation of a shape", "[shapes]")
+{
+  TestShape s;
+  CHECK(s.transform() == Matrix::identity_matrix(4));
+}
+
+TEST_CASE("Assigning a transformation to a shape", "[shapes]")
+{
+  TestShape s;
+  s.set_transform(translation(2, 3, 4));
+  CHECK(s.transform() == translation(2, 3, 4));
+}
+
+TEST_CASE("The default material of a shape", "[shapes]")
+{
+  TestShape s;
+  CHECK(s.material() == Material());
+}
+
+TEST_CASE("Assigning a material to a shape", "[shapes]")
+{
+  TestShape s;
+  Material m;
+  m.set_ambient(1);
+  s.set_material(m);
+  CHECK(s.material() == m);
+}
+
+TEST_CASE("Intersecting a scaled shape with a ray", "[shapes]")
+{
+  Ray r(point(0, 0, -5), vector(0, 0, 1));
+  TestShape s;
+  s.set_transform(scaling(2, 2, 2));
+  Intersections xs = s.intersect(r);
+  CHECK(xs.empty());
+  CHECK(s.saved_ray.origin() == point(0, 0, -2.5));
+  CHECK(s.saved_ray.direction() == vector(0, 0, 0.5));
+}
+
+TEST_CASE("Intersecting a translated shape with a ray", "[shapes]")
+{
+  Ray r(point(0, 0, -5), vector(0, 0, 1));
+  TestShape s;
+  s.set_transform(translation(5, 0, 0));
+  s.intersect(r);
+  CHECK(s.saved_ray.origin() == point(-5, 0, -5));
+  CHECK(s.saved_ray.direction() == vector(0, 0, 1));
+}
+
+TEST_CASE("Computing the normal on a translated shape", "[shapes]")
+{
+  TestShape s;
+  s.set_transform(translation(0, 1, 0));
+  Tuple n = s.normal_at(point(0, 1.70711, -0.70711));
+  CHECK(approximately_equal(n, vector(0, 0.70711, -0.70711)));
+}
+
+TEST_CASE("Computing the normal on a transformed shape", "[shapes]")
+{
+  TestShape s;
+  s.set_transform(scaling(1, 0.5, 1) * rotation_z(M_PI / 5));
+  Tuple n = s.normal_at(point(0, sqrt(2)/2, -sqrt(2)/2));
+  CHECK(approximately_equal(n, vector(0, 0.97014, -0.24254)));
+}
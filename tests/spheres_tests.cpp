@@ -1,6 +1,9 @@
 #include <catch2/catch.hpp>
 
 #include <raytracer/intersection.h>
+#include <raytracer/sphere.h>
+#include <raytracer/sphere_store.h>
+#include <raytracer/test_utils.h>
 #include <raytracer/transform.h>
 
 TEST_CASE("A ray intersects a sphere at two points", "[spheres]")
@@ -75,6 +78,16 @@ TEST_CASE("Changing a sphere's transformation", "[spheres]")
   CHECK(s.transform() == t);
 }
 
+TEST_CASE("Changing a sphere's transformation caches its inverse", "[spheres]")
+{
+  Sphere s;
+  CHECK(s.inverse_transform() == Matrix::identity_matrix(4));
+  Matrix t = translation(2, 3, 4) * scaling(1, 2, 3);
+  s.set_transform(t);
+  CHECK(s.inverse_transform().nearly_equal(t.inverse()));
+  CHECK(s.normal_transform().nearly_equal(t.inverse().transpose()));
+}
+
 TEST_CASE("Intersecting a scaled sphere with a ray", "[spheres]")
 {
   Ray r(point(0, 0, -5), vector(0, 0, 1));
@@ -120,14 +133,22 @@ TEST_CASE("The normal on a sphere at a non-axial point", "[spheres]")
 {
   Sphere s;
   Tuple n = s.normal_at(point(sqrt(3)/3, sqrt(3)/3, sqrt(3)/3));
+#if defined(RAYTRACER_FLOAT)
+  CHECK(nearly_equal(n, vector(sqrt(3)/3, sqrt(3)/3, sqrt(3)/3)));
+#else
   CHECK(n == vector(sqrt(3)/3, sqrt(3)/3, sqrt(3)/3));
+#endif
 }
 
 TEST_CASE("The normal is a normalized vector", "[spheres]")
 {
   Sphere s;
   Tuple n = s.normal_at(point(sqrt(3)/3, sqrt(3)/3, sqrt(3)/3));
+#if defined(RAYTRACER_FLOAT)
+  CHECK(nearly_equal(n, n.normalize()));
+#else
   CHECK(n == n.normalize());
+#endif
 }
 
 TEST_CASE("Computing the normal on a translated sphere", "[spheres]")
@@ -163,6 +184,137 @@ TEST_CASE("A sphere may be assigned a material", "[spheres]")
   CHECK(s.material() == m);
 }
 
+TEST_CASE("A sphere's accessors return its own transform and material", "[spheres]")
+{
+  Sphere s;
+  s.set_transform(translation(2, 3, 4));
+  Material m;
+  m.set_color(Color(0.1, 0.2, 0.3));
+  s.set_material(Material(m));
+  CHECK(&s.transform() == &s.transform());
+  CHECK(s.transform() == translation(2, 3, 4));
+  CHECK(s.inverse_transform() == translation(-2, -3, -4));
+  CHECK(&s.material() == &s.material());
+  CHECK(s.material() == m);
+  CHECK(&s.material().color() == &s.material().color());
+}
+
+TEST_CASE("Intersections are appended to a list", "[spheres]")
+{
+  Sphere s;
+  Intersections xs = {{-1, s}};
+  s.intersect(Ray(point(0, 0, -5), vector(0, 0, 1)), xs);
+  s.intersect(Ray(point(0, 2, -5), vector(0, 0, 1)), xs);
+  REQUIRE(xs.size() == 3);
+  CHECK(xs[0].t() == -1);
+  CHECK(xs[1].t() == 4);
+  CHECK(xs[2].t() == 6);
+}
+
+TEST_CASE("A ray packet intersects a sphere like single rays", "[spheres]")
+{
+  Sphere s;
+  s.set_transform(translation(0.25, -0.5, 1) * scaling(2, 1.5, 1));
+  RayPacket8 packet;
+  packet.count = 6;
+  packet.set(0, Ray(point(0, 0, -5), vector(0, 0, 1)));
+  packet.set(1, Ray(point(0, 0, -5), vector(0, 1, 0)));
+  packet.set(2, Ray(point(0.1, 0.2, 1), vector(0.3, 0.6, 0.7).normalize()));
+  packet.set(3, Ray(point(-3, 1, 0), vector(1, -0.2, 0.1).normalize()));
+  packet.set(4, Ray(point(0, 0, 5), vector(0, 0, 1)));
+  packet.set(5, Ray(point(2.25, 0, -5), vector(0, 0, 1)));
+  packet.pad();
+
+  RayPacketHits<8> hits;
+  s.intersect_packet(packet, hits);
+  for (int lane = 0; lane < packet.count; ++lane)
+  {
+    Scalar t_1 = 0;
+    Scalar t_2 = 0;
+    bool hit = s.intersect_distances(packet.ray(lane), t_1, t_2);
+    CHECK(hits.hit[lane] == hit);
+    if (hit)
+    {
+      CHECK(hits.t_1[lane] == t_1);
+      CHECK(hits.t_2[lane] == t_2);
+    }
+  }
+  CHECK_FALSE(hits.hit[1]);
+  CHECK(hits.hit[4]);
+}
+
+TEST_CASE("A sphere store intersects like the spheres it copies", "[spheres]")
+{
+  std::vector<std::unique_ptr<Sphere>> spheres;
+  spheres.push_back(Sphere::new_ptr());
+  spheres.push_back(Sphere::new_ptr());
+  spheres.back()->set_transform(translation(0.25, -0.5, 1) * scaling(2, 1.5, 1));
+  spheres.push_back(Sphere::new_ptr());
+  spheres.back()->set_transform(rotation_y(0.5) * scaling(0.5, 0.5, 0.5));
+  SphereStore store;
+  store.build(spheres);
+  REQUIRE(store.size() == 3);
+
+  RayPacket4 packet;
+  packet.count = 4;
+  packet.set(0, Ray(point(0, 0, -5), vector(0, 0, 1)));
+  packet.set(1, Ray(point(0.1, 0.2, 1), vector(0.3, 0.6, 0.7).normalize()));
+  packet.set(2, Ray(point(-3, 1, 0), vector(1, -0.2, 0.1).normalize()));
+  packet.set(3, Ray(point(0, 3, -5), vector(0, 0, 1)));
+  bool matching = true;
+  for (int i = 0; i < store.size(); ++i)
+  {
+    CHECK(store.bounds()[i].minimum() == spheres[i]->bounds().minimum());
+    RayPacketHits<4> hits;
+    RayPacketHits<4> expected_hits;
+    store.intersect_packet(i, packet, hits);
+    spheres[i]->intersect_packet(packet, expected_hits);
+    for (int lane = 0; lane < packet.count; ++lane)
+    {
+      Scalar t_1 = 0;
+      Scalar t_2 = 0;
+      Scalar expected_t_1 = 0;
+      Scalar expected_t_2 = 0;
+      bool hit = store.intersect_distances(i, packet.ray(lane), t_1, t_2);
+      bool expected = spheres[i]->intersect_distances(packet.ray(lane),
+                                                      expected_t_1,
+                                                      expected_t_2);
+      matching = matching && hit == expected &&
+                 hits.hit[lane] == expected_hits.hit[lane];
+      if (expected)
+      {
+        matching = matching && t_1 == expected_t_1 && t_2 == expected_t_2 &&
+                   hits.t_1[lane] == expected_hits.t_1[lane] &&
+                   hits.t_2[lane] == expected_hits.t_2[lane];
+      }
+    }
+  }
+  CHECK(matching);
+  store.clear();
+  CHECK(store.size() == 0);
+}
+
+TEST_CASE("A sphere store copies a changed sphere again", "[spheres]")
+{
+  std::vector<std::unique_ptr<Sphere>> spheres;
+  spheres.push_back(Sphere::new_ptr());
+  spheres.push_back(Sphere::new_ptr());
+  SphereStore store;
+  store.build(spheres);
+  spheres[1]->set_transform(translation(0, 5, 0));
+  store.set(1, *spheres[1]);
+  REQUIRE(store.size() == 2);
+  CHECK(store.bounds()[1].minimum() == point(-1, 4, -1));
+  Scalar t_1 = 0;
+  Scalar t_2 = 0;
+  CHECK(store.intersect_distances(1, Ray(point(0, 5, -5), vector(0, 0, 1)),
+                                  t_1, t_2));
+  CHECK(t_1 == 4);
+  CHECK(t_2 == 6);
+  CHECK_FALSE(store.intersect_distances(0, Ray(point(0, 5, -5),
+                                               vector(0, 0, 1)), t_1, t_2));
+}
+
 #if 0
 TEST_CASE("A helper for producing a sphere with a glassy material", "[spheres]")
 {
@@ -0,0 +1,96 @@
+#include <catch2/catch.hpp>
+
+#include <raytracer/matrix.h>
+#include <raytracer/square_matrix.h>
+#include <raytracer/transform.h>
+
+
+namespace
+{
+
+constexpr Matrix4 A = {
+  {-2, -8, 3, 5},
+  {-3, 1, 7, 3},
+  {1, 2, -9, 6},
+  {-6, 7, 7, -9}
+};
+
+} // namespace
+
+TEST_CASE("Fixed size matrices are evaluated at compile time", "[square_matrices]")
+{
+  static_assert(A(1, 2) == 7, "construction");
+  static_assert(A.determinant() == -4071, "determinant");
+  static_assert(A.cofactor(0, 1) == 447, "cofactor");
+  static_assert(A.transpose()(2, 1) == 7, "transpose");
+  static_assert(A * Matrix4::identity() == A, "multiply by identity");
+  static_assert(Matrix3::size() == 3, "size");
+  static_assert(Matrix2({{1, 5}, {-3, 2}}).determinant() == 17, "2x2 determinant");
+  CHECK(A(3, 0) == -6);
+}
+
+TEST_CASE("A submatrix of a fixed size 3x3 matrix is a 2x2 matrix", "[square_matrices]")
+{
+  constexpr Matrix3 B = {
+    {1, 5, 0},
+    {-3, 2, 7},
+    {0, 6, -3}
+  };
+  constexpr Matrix2 expected = {
+    {-3, 2},
+    {0, 6}
+  };
+  static_assert(B.sub_matrix(0, 2) == expected, "sub matrix");
+  CHECK(B.sub_matrix(0, 2) == expected);
+}
+
+TEST_CASE("Fixed size matrices match the runtime sized Matrix", "[square_matrices]")
+{
+  Matrix m = translation(1, 2, 3) * rotation_x(0.5) * scaling(2, 3, 4);
+  Matrix4 f = m.to_matrix4();
+  CHECK(Matrix(f) == m);
+  CHECK(Matrix(f.inverse()) == m.inverse());
+  CHECK(Matrix(f.transpose()) == m.transpose());
+  CHECK(f.determinant() == m.determinant());
+  Tuple p = point(1, -2, 3);
+  CHECK(f * p == m * p);
+}
+
+TEST_CASE("The closed form inverse matches cofactor expansion", "[square_matrices]")
+{
+  constexpr Matrix4 B = {
+    {-5, 2, 6, -8},
+    {1, -5, 1, 8},
+    {7, 7, -6, -7},
+    {1, -3, 7, 4}
+  };
+  static_assert(general_inverse(B)(3, 2) == Scalar(-160) / 532, "closed form");
+  static_assert(!is_affine(B), "not affine");
+  Matrix expected;
+  for (size_t row = 0; row < 4; ++row)
+    for (size_t col = 0; col < 4; ++col)
+      expected[col][row] = B.cofactor(row, col) / B.determinant();
+  CHECK(Matrix(general_inverse(B)).nearly_equal(expected));
+  CHECK(Matrix(B.inverse()).nearly_equal(expected));
+}
+
+TEST_CASE("Inverting affine transformations", "[square_matrices]")
+{
+  Matrix transforms[] = {
+    translation(5, -3, 2),
+    scaling(2, 3, 4),
+    rotation_x(0.3) * rotation_y(1.1) * rotation_z(-0.7),
+    shearing(1, 0.5, 0, 2, 0.25, 1),
+    view_transform(point(1, 3, 2), point(4, -2, 8), vector(1, 1, 0)),
+    translation(1, 2, 3) * rotation_y(0.5) * scaling(0.5, 2, 1)
+  };
+  for (auto& transform : transforms)
+  {
+    Matrix4 m = transform.to_matrix4();
+    CHECK(is_affine(m));
+    Matrix expected = general_inverse(m);
+    CHECK(Matrix(affine_inverse(m)).nearly_equal(expected));
+    CHECK((transform * Matrix(affine_inverse(m))).nearly_equal(
+        Matrix::identity_matrix()));
+  }
+}
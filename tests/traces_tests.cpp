@@ -0,0 +1,90 @@
+#include <catch2/catch.hpp>
+
+#include <sstream>
+#include <string>
+
+#include <raytracer/camera.h>
+#include <raytracer/scenes.h>
+#include <raytracer/trace.h>
+#include <raytracer/world.h>
+
+namespace
+{
+
+//------------------------------------------------------------------------------
+int occurrences(const std::string& a_text, const std::string& a_pattern)
+{
+  int count = 0;
+  for (size_t at = a_text.find(a_pattern); at != std::string::npos;
+       at = a_text.find(a_pattern, at + 1))
+  {
+    ++count;
+  }
+  return count;
+}
+
+} // namespace
+
+TEST_CASE("Spans are only recorded while tracing is on", "[traces]")
+{
+  trace::clear();
+  CHECK_FALSE(trace::enabled());
+  {
+    trace::Span span("untraced");
+  }
+  CHECK(trace::span_count() == 0);
+
+  trace::set_enabled(true);
+  {
+    trace::Span outer("outer");
+    trace::Span inner("inner");
+  }
+  trace::set_enabled(false);
+  CHECK(trace::span_count() == 2);
+  trace::clear();
+  CHECK(trace::span_count() == 0);
+}
+
+TEST_CASE("A traced render records a span for each tile of every thread", "[traces]")
+{
+  World w = chapter_7_world();
+  Camera c = chapter_7_camera(37, 23);
+  c.set_tile_size(8);
+  c.set_thread_count(3);
+
+  trace::clear();
+  trace::set_enabled(true);
+  w.build_bvh();
+  c.render(w);
+  c.render(w);
+  trace::set_enabled(false);
+
+  std::ostringstream out;
+  trace::write_json(out);
+  std::string json = out.str();
+  trace::clear();
+
+  CHECK(json.find("{\"traceEvents\": [") == 0);
+  CHECK(occurrences(json, "\"name\": \"build bvh\"") == 1);
+  CHECK(occurrences(json, "\"name\": \"render\"") == 2);
+  // 5 tiles across and 3 down for each render
+  CHECK(occurrences(json, "\"name\": \"tile\"") == 30);
+  CHECK(occurrences(json, "\"ph\": \"X\"") == 33);
+  // buffers of finished render threads are reused by the next render
+  CHECK(occurrences(json, "\"tid\": 4") == 0);
+
+  // times are microseconds with three decimals, never in exponent form
+  bool fixed_times = true;
+  for (size_t at = json.find("\"ts\": "); at != std::string::npos;
+       at = json.find("\"ts\": ", at + 1))
+  {
+    size_t number = at + 6;
+    size_t point = json.find('.', number);
+    size_t comma = json.find(',', number);
+    fixed_times = fixed_times && point < comma && comma - point == 4 &&
+                  json.find_first_not_of("0123456789", number) == point;
+  }
+  CHECK(fixed_times);
+  CHECK(out.precision() == 6);
+  CHECK((out.flags() & std::ios::fixed) == 0);
+}
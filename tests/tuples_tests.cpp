@@ -3,15 +3,17 @@
 #include <catch2/catch.hpp>
 
 #include <raytracer/color.h>
+#include <raytracer/square_matrix.h>
+#include <raytracer/test_utils.h>
 #include <raytracer/tuple.h>
 
 
 TEST_CASE("A tuple with w=1.0 is a point", "[tuples]")
 {
   Tuple a = Tuple(4.3, -4.2, 3.1, 1.0);
-  CHECK(a.x() == 4.3);
-  CHECK(a.y() == -4.2);
-  CHECK(a.z() == 3.1);
+  CHECK(a.x() == Scalar(4.3));
+  CHECK(a.y() == Scalar(-4.2));
+  CHECK(a.z() == Scalar(3.1));
   CHECK(a.w() == 1.0);
   CHECK(a.is_point());
   CHECK_FALSE(a.is_vector());
@@ -20,9 +22,9 @@ TEST_CASE("A tuple with w=1.0 is a point", "[tuples]")
 TEST_CASE("A tuple with w=0 is a vector", "[tuples]")
 {
   Tuple a(4.3, -4.2, 3.1, 0.0);
-  CHECK(a.x() == 4.3);
-  CHECK(a.y() == -4.2);
-  CHECK(a.z() == 3.1);
+  CHECK(a.x() == Scalar(4.3));
+  CHECK(a.y() == Scalar(-4.2));
+  CHECK(a.z() == Scalar(3.1));
   CHECK(a.w() == 0.0);
   CHECK_FALSE(a.is_point());
   CHECK(a.is_vector());
@@ -120,13 +122,13 @@ TEST_CASE("Computing the magnitude of vector(0, 0, 1)", "[tuples]")
 TEST_CASE("Computing the magnitude of vector(1, 2, 3)", "[tuples]")
 {
   Tuple v = vector(1, 2, 3);
-  CHECK(v.magnitude() == sqrt(14));
+  CHECK(v.magnitude() == Scalar(sqrt(14)));
 }
 
 TEST_CASE("Computing the magnitude of vector(-1, -2, -3)", "[tuples]")
 {
   Tuple v = vector(-1, -2, -3);
-  CHECK(v.magnitude() == sqrt(14));
+  CHECK(v.magnitude() == Scalar(sqrt(14)));
 }
 
 TEST_CASE("Normalizing vector(4, 0, 0) gives (1, 0, 0)", "[tuples]")
@@ -145,7 +147,11 @@ TEST_CASE("The magnitude of a normalized vector", "[tuples]")
 {
   Tuple v = vector(1, 2, 3);
   Tuple norm = v.normalize();
+#if defined(RAYTRACER_FLOAT)
+  CHECK(nearly_equal(norm.magnitude(), 1));
+#else
   CHECK(norm.magnitude() == 1);
+#endif
 }
 
 TEST_CASE("The dot product of two tuples", "[tuples]")
@@ -167,15 +173,19 @@ TEST_CASE("Colors are (red, green, blue) tuples", "[tuples]")
 {
   Color c(-0.5, 0.4, 1.7);
   CHECK(c.red() == -0.5);
-  CHECK(c.green() == 0.4);
-  CHECK(c.blue() == 1.7);
+  CHECK(c.green() == Scalar(0.4));
+  CHECK(c.blue() == Scalar(1.7));
 }
 
 TEST_CASE("Adding colors", "[tuples]")
 {
   Color c1(0.9, 0.6, 0.75);
   Color c2(0.7, 0.1, 0.25);
+#if defined(RAYTRACER_FLOAT)
+  CHECK(nearly_equal(c1 + c2, Color(1.6, 0.7, 1.0)));
+#else
   CHECK(c1 + c2 == Color(1.6, 0.7, 1.0));
+#endif
 }
 
 TEST_CASE("Subtracting colors", "[tuples]")
@@ -213,3 +223,26 @@ TEST_CASE("Reflecting a vector off a slanted surface", "[tuples]")
   Tuple r = reflect(v, n);
   CHECK(nearly_equal(r, vector(1, 0, 0)));
 }
+
+TEST_CASE("Tuple kernels round the same as the scalar formulas", "[tuples]")
+{
+  Tuple a(0.1, -2.3, 1.0 / 3.0, 0.7);
+  Tuple b(5.9, 0.01, -1.0 / 7.0, 0.3);
+  CHECK(dot(a, b) == a.x() * b.x() + a.y() * b.y() + a.z() * b.z() + a.w() * b.w());
+  CHECK(cross(a, b) == vector(a.y() * b.z() - a.z() * b.y(),
+                              a.z() * b.x() - a.x() * b.z(),
+                              a.x() * b.y() - a.y() * b.x()));
+  CHECK(a.magnitude() ==
+        std::sqrt(a.x() * a.x() + a.y() * a.y() + a.z() * a.z() + a.w() * a.w()));
+
+  Matrix4 m = {{0.3, -1.1, 2.7, 4.0},
+               {1.0 / 3.0, 0.2, -0.9, 1.5},
+               {-2.2, 0.6, 1.0 / 7.0, -3.0},
+               {0.0, 0.0, 0.0, 1.0}};
+  Tuple product = m * a;
+  for (int row = 0; row < 4; ++row)
+  {
+    CHECK(product.data()[row] == m(row, 0) * a.x() + m(row, 1) * a.y() +
+                                 m(row, 2) * a.z() + m(row, 3) * a.w());
+  }
+}
@@ -1,3 +1,7 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
 #include <catch2/catch.hpp>
 
 #include <raytracer/color.h>
@@ -5,10 +9,37 @@
 #include <raytracer/light.h>
 #include <raytracer/material.h>
 #include <raytracer/ray.h>
+#include <raytracer/scenes.h>
 #include <raytracer/sphere.h>
 #include <raytracer/transform.h>
 #include <raytracer/world.h>
 
+namespace
+{
+std::atomic<long> allocation_count(0); ///< Calls to operator new so far.
+} // namespace
+
+// count every allocation made by the test program so tests can check that
+// code does not allocate
+void* operator new(std::size_t a_size)
+{
+  ++allocation_count;
+  void* memory = std::malloc(a_size == 0 ? 1 : a_size);
+  if (!memory)
+    throw std::bad_alloc();
+  return memory;
+}
+
+void operator delete(void* a_memory) noexcept
+{
+  std::free(a_memory);
+}
+
+void operator delete(void* a_memory, std::size_t) noexcept
+{
+  std::free(a_memory);
+}
+
 TEST_CASE("intersect a world with a ray", "[world]")
 {
   auto w = default_world();
@@ -21,6 +52,169 @@ TEST_CASE("intersect a world with a ray", "[world]")
   CHECK(xs[3].t() == 6);
 }
 
+TEST_CASE("The closest hit of a ray in the world", "[world]")
+{
+  World w = default_world();
+  Ray r(point(0, 0, -5), vector(0, 0, 1));
+  Scalar t = 0;
+  const Shape* object = w.closest_hit(r, t);
+  CHECK(object == &w.object(0));
+  CHECK(t == 4);
+}
+
+TEST_CASE("The closest hit of a ray starting inside objects", "[world]")
+{
+  World w = default_world();
+  Ray r(point(0, 0, 0), vector(0, 0, 1));
+  Scalar t = 0;
+  const Shape* object = w.closest_hit(r, t);
+  CHECK(object == &w.object(1));
+  CHECK(t == 0.5);
+}
+
+TEST_CASE("The closest hit of a ray that misses the world", "[world]")
+{
+  World w = default_world();
+  Ray r(point(0, 0, -5), vector(0, 1, 0));
+  Scalar t = 0;
+  CHECK(w.closest_hit(r, t) == nullptr);
+}
+
+TEST_CASE("Any hit only finds objects before the given distance", "[world]")
+{
+  World w = default_world();
+  Ray r(point(0, 0, -5), vector(0, 0, 1));
+  CHECK(w.any_hit(r, 10));
+  CHECK(w.any_hit(r, 4.25));
+  CHECK_FALSE(w.any_hit(r, 3.5));
+  CHECK_FALSE(w.any_hit(Ray(point(0, 0, 5), vector(0, 0, 1)), 100));
+}
+
+TEST_CASE("Objects changed through the world are intersected as changed", "[world]")
+{
+  World w = default_world();
+  Ray r(point(0, 0, -5), vector(0, 0, 1));
+  Scalar t = 0;
+  w.set_object_transform(0, translation(0, 0, 10));
+  const Sphere* expected = &w.object(1);
+  CHECK(w.closest_hit(r, t) == expected);
+  CHECK(t == 4.5);
+  w.add_object(Sphere::new_ptr());
+  w.set_object_transform(2, translation(0, 0, -2));
+  w.build_bvh();
+  expected = &w.object(2);
+  CHECK(w.closest_hit(r, t) == expected);
+  CHECK(t == 2);
+  w.add_object(Sphere::new_ptr());
+  const World& view = w;
+  CHECK(view.closest_hit(r, t) == &view.object(2));
+  CHECK(t == 2);
+}
+
+TEST_CASE("Objects changed after building the hierarchy are intersected as changed", "[world]")
+{
+  World w;
+  for (int i = 0; i < 8; ++i)
+  {
+    w.add_object(Sphere::new_ptr());
+    w.set_object_transform(i, translation(3 * i, 0, 0));
+  }
+  w.build_bvh();
+  w.set_object_transform(0, translation(0, 50, 0));
+  CHECK(w.bvh().empty());
+  Ray r(point(0, 50, -5), vector(0, 0, 1));
+  Scalar t = 0;
+  const Sphere* expected = &w.object(0);
+  CHECK(w.closest_hit(r, t) == expected);
+  CHECK(w.intersect(r).size() == 2);
+  w.build_bvh();
+  CHECK_FALSE(w.bvh().empty());
+  CHECK(w.closest_hit(r, t) == expected);
+  CHECK(t == 4);
+}
+
+TEST_CASE("Getting an object to change keeps the hierarchy", "[world]")
+{
+  World w = default_world();
+  w.build_bvh();
+  Material material = w.object(0).material();
+  material.set_ambient(1);
+  w.object(0).set_material(material);
+  CHECK_FALSE(w.bvh().empty());
+  Scalar t = 0;
+  const Sphere* expected = &w.object(0);
+  CHECK(w.closest_hit(Ray(point(0, 0, -5), vector(0, 0, 1)), t) == expected);
+  CHECK(t == 4);
+}
+
+TEST_CASE("The closest hits of a ray packet match single rays", "[world]")
+{
+  World w = default_world();
+  w.add_object(Sphere::new_ptr());
+  w.set_object_transform(2, translation(0, 0, 3));
+  RayPacket4 packet;
+  packet.count = 3;
+  packet.set(0, Ray(point(0, 0, -5), vector(0, 0, 1)));
+  packet.set(1, Ray(point(0, 0, 0), vector(0, 0, 1)));
+  packet.set(2, Ray(point(0, 0, -5), vector(0, 1, 0)));
+  packet.pad();
+
+  for (int pass = 0; pass < 2; ++pass)
+  {
+    if (pass == 1)
+      w.build_bvh();
+    const Shape* objects[4];
+    Scalar t[4];
+    w.closest_hits(packet, objects, t);
+    for (int lane = 0; lane < packet.count; ++lane)
+    {
+      Scalar expected_t = 0;
+      const Shape* expected = w.closest_hit(packet.ray(lane), expected_t);
+      CHECK(objects[lane] == expected);
+      if (expected)
+        CHECK(t[lane] == expected_t);
+    }
+    CHECK(objects[2] == nullptr);
+    CHECK(objects[3] == nullptr);
+  }
+}
+
+TEST_CASE("Intersecting into a reused list does not allocate", "[world]")
+{
+  World w = default_world();
+  Ray r(point(0, 0, -5), vector(0, 0, 1));
+  Intersections xs;
+  w.intersect(r, xs);
+  long allocations = allocation_count;
+  w.intersect(r, xs);
+  CHECK(allocation_count == allocations);
+  REQUIRE(xs.size() == 4);
+  CHECK(xs[0].t() == 4);
+  CHECK(xs[3].t() == 6);
+
+  Intersections fresh = w.intersect(r);
+  CHECK(allocation_count > allocations);
+}
+
+TEST_CASE("color_at() and is_shadowed() do not allocate", "[world]")
+{
+  World w = default_world();
+  Ray r(point(0, 0, -5), vector(0, 0, 1));
+  for (int pass = 0; pass < 2; ++pass)
+  {
+    if (pass == 1)
+      w.build_bvh();
+    long allocations = allocation_count;
+    Color color = w.color_at(r);
+    bool lit = w.is_shadowed(point(-2, 2, -2));
+    bool shadowed = w.is_shadowed(point(10, -10, 10));
+    CHECK(allocation_count == allocations);
+    CHECK(approximately_equal(color, Color(0.38066, 0.47583, 0.2855)));
+    CHECK_FALSE(lit);
+    CHECK(shadowed);
+  }
+}
+
 TEST_CASE("Shading an intersection", "[world]")
 {
   World w = default_world();
@@ -104,6 +298,105 @@ TEST_CASE("There is no shadow when an object is behind the point", "[world]")
   CHECK_FALSE(w.is_shadowed(p));
 }
 
+TEST_CASE("Setting a null light leaves the world without lights", "[world]")
+{
+  World w = default_world();
+  w.add_light(Light(point(10, 10, -10), Color(1, 1, 1)));
+  w.set_light(nullptr);
+  CHECK(w.light_count() == 0);
+  CHECK_FALSE(w.is_shadowed(point(10, -10, 10)));
+  Ray r(point(0, 0, -5), vector(0, 0, 1));
+  CHECK(w.color_at(r) == Color(0, 0, 0));
+}
+
+TEST_CASE("A shadow cache tests the last blocking object first", "[world]")
+{
+  World w = default_world();
+  ShadowCache cache;
+  CHECK(w.is_shadowed(point(10, -10, 10), &cache));
+  CHECK(cache.last_occluder >= 0);
+  CHECK(cache.stats.lookups == 1);
+  CHECK(cache.stats.hits == 0);
+  CHECK(w.is_shadowed(point(10, -10, 9), &cache));
+  CHECK(cache.stats.hits == 1);
+  CHECK_FALSE(w.is_shadowed(point(0, 10, 0), &cache));
+  CHECK_FALSE(w.is_shadowed(point(-2, 2, -2), &cache));
+  CHECK(cache.stats.lookups == 4);
+  CHECK(cache.stats.hits == 1);
+  CHECK(cache.stats.hit_rate() == 0.25);
+  CHECK(ShadowCacheStats().hit_rate() == 0.0);
+}
+
+TEST_CASE("A world holds several lights", "[world]")
+{
+  World w = default_world();
+  CHECK(w.light_count() == 1);
+  w.add_light(Light(point(10, 10, -10), Color(0.5, 0.5, 0.5)));
+  REQUIRE(w.light_count() == 2);
+  CHECK(w.light(1).position() == point(10, 10, -10));
+  w.set_light(Light::new_ptr(point(0, 5, 0), Color(1, 1, 1)));
+  REQUIRE(w.light_count() == 1);
+  CHECK(w.light(0).position() == point(0, 5, 0));
+}
+
+TEST_CASE("shade_hit() sums the contribution of every light", "[world]")
+{
+  World w = chapter_7_world();
+  for (int i = 0; i < 11; ++i)
+  {
+    Scalar angle = Scalar(i) * 2 * Scalar(M_PI) / 11;
+    w.add_light(Light(point(8 * std::cos(angle), 1 + i % 4, 8 * std::sin(angle)),
+                      Color(0.1, 0.05 * (i % 3), 0.2)));
+  }
+  for (bool with_bvh : {false, true})
+  {
+    if (with_bvh)
+      w.build_bvh();
+    ShadowCache cache;
+    bool matching = true;
+    for (int x = -4; x <= 4; ++x)
+    {
+      for (int y = -1; y <= 3; ++y)
+      {
+        Ray r(point(0, 1.5, -5), vector(x * 0.1, y * 0.1 - 0.1, 1).normalize());
+        Scalar t;
+        const Shape* object = w.closest_hit(r, t);
+        if (!object)
+          continue;
+        Computations comps = Intersection(t, *object).prepare_computations(r);
+        Color expected;
+        for (int i = 0; i < w.light_count(); ++i)
+        {
+          bool shadowed = w.is_shadowed(comps.over_point, w.light(i));
+          expected = expected + lighting(object->material(), w.light(i),
+                                         comps.point, comps.to_eye,
+                                         comps.normal, shadowed);
+        }
+        matching = matching && w.shade_hit(comps) == expected &&
+                   w.shade_hit(comps, &cache) == expected;
+      }
+    }
+    CHECK(matching);
+    CHECK(cache.stats.lookups > 0);
+  }
+}
+
+TEST_CASE("Lights behind the surface or too dim cast no shadow rays", "[world]")
+{
+  World w = default_world();
+  w.set_light(Light::new_ptr(point(0, 0, 10), Color(1, 1, 1)));
+  w.add_light(Light(point(0, 0, -10), Color(0.001, 0.001, 0.001)));
+  w.set_light_threshold(0.01);
+  CHECK(w.light_threshold() == Scalar(0.01));
+  Ray r(point(0, 0, -5), vector(0, 0, 1));
+  Intersection i(4, w.object(0));
+  Computations comps = i.prepare_computations(r);
+  ShadowCache cache;
+  Color c = w.shade_hit(comps, &cache);
+  CHECK(cache.stats.lookups == 0);
+  CHECK(c == w.object(0).material().color() * w.object(0).material().ambient());
+}
+
 TEST_CASE("shade_hit() is given an intersection in shadow", "[world]")
 {
   World w;